@@ -1,8 +1,39 @@
 #include "raylib.h"
+#include "rlgl.h"
 #include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <future>
+#include <utility>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#if defined(_WIN32)
+// windows.h clashes with raylib.h, so level files are read into memory there instead of mapped
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 
 // VectorUtils class for utility functions
 class VectorUtils {
@@ -23,6 +54,10 @@ public:
         return {v1.x + v2.x, v1.y + v2.y};
     }
 
+    static float Dot(Vector2 v1, Vector2 v2) {
+        return v1.x * v2.x + v1.y * v2.y;
+    }
+
     static Vector2 Normalize(Vector2 v) {
         float length = Length(v);
         if (length != 0) {
@@ -33,40 +68,228 @@ public:
     }
 };
 
-// Object class as a base class for Wall and Coin
-class Object {
+// Random class for a small seeded generator that can be copied into worker threads
+class Random {
+public:
+    uint64_t state;
+
+    explicit Random(uint64_t seed = 0) : state(seed) {}
+
+    // splitmix64 step
+    uint32_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+
+    // Uniform integer in [0, n)
+    int range(int n) {
+        return static_cast<int>(next() % static_cast<uint32_t>(n));
+    }
+
+    // Uniform float in [0, 1)
+    float uniform() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// SpriteBatch class drawing circles and thick lines as textured quads from one prebuilt circle
+// texture, so a frame's coins and characters go out in a single rlgl batch instead of one
+// tessellated circle (and a mode switch) per entity
+class SpriteBatch {
 public:
-    virtual void draw() = 0;
-    virtual ~Object() = default; // Virtual destructor
+    Texture2D circle;
+
+    SpriteBatch() : circle({0, 0, 0, 0, 0}) {}
+
+    // Needs a GL context, so call after InitWindow()
+    void load() {
+        const int size = 64;
+        Image image = GenImageColor(size, size, BLANK);
+        ImageDrawCircle(&image, size / 2, size / 2, size / 2 - 1, WHITE);
+        circle = LoadTextureFromImage(image);
+        UnloadImage(image);
+        SetTextureFilter(circle, TEXTURE_FILTER_BILINEAR);
+    }
+
+    void unload() {
+        if (circle.id != 0) UnloadTexture(circle);
+        circle.id = 0;
+    }
+
+    void begin() {
+        rlSetTexture(circle.id);
+        rlBegin(RL_QUADS);
+    }
+
+    void end() {
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+    void drawCircle(Vector2 center, float radius, Color color) {
+        quad({center.x - radius, center.y - radius}, {center.x - radius, center.y + radius},
+             {center.x + radius, center.y + radius}, {center.x + radius, center.y - radius}, 0.0f, 1.0f, color);
+    }
+
+    // Samples the solid middle of the circle texture, so lines share the batch with the circles
+    void drawLine(Vector2 start, Vector2 end, float thick, Color color) {
+        Vector2 direction = VectorUtils::Normalize(VectorUtils::Subtract(end, start));
+        Vector2 side = VectorUtils::Scale({-direction.y, direction.x}, thick / 2.0f);
+        quad(VectorUtils::Subtract(start, side), VectorUtils::Add(start, side),
+             VectorUtils::Add(end, side), VectorUtils::Subtract(end, side), 0.5f, 0.5f, color);
+    }
+
+private:
+    void quad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, float u0, float u1, Color color) {
+        rlCheckRenderBatchLimit(4); // Flushes and keeps going when the batch is full
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        rlTexCoord2f(u0, u0);
+        rlVertex2f(a.x, a.y);
+        rlTexCoord2f(u0, u1);
+        rlVertex2f(b.x, b.y);
+        rlTexCoord2f(u1, u1);
+        rlVertex2f(c.x, c.y);
+        rlTexCoord2f(u1, u0);
+        rlVertex2f(d.x, d.y);
+    }
 };
 
-// Wall class inheriting from Object
-class Wall : public Object {
+// Entities are concrete, non-virtual types stored by value: levels hold std::vector<Wall> and
+// std::vector<Coin>, so the update and draw loops walk contiguous memory with direct calls
+
+// Wall class for a solid rectangle
+class Wall {
 public:
     Rectangle rect;
 
     Wall(Rectangle r) : rect(r) {}
 
-    void draw() override {
+    void draw() const {
         DrawRectangleRec(rect, GRAY);
     }
 };
 
-// Door class inheriting from Object
-class Door : public Object {
+// Door class for the level exit
+class Door {
 public:
     Rectangle rect;
     bool isOpen;
 
     Door(Rectangle r) : rect(r), isOpen(false) {}
 
-    void draw() override {  
+    void draw() const {
         if (isOpen) {
             DrawRectangleRec(rect, BROWN);
         }
     }
 };
 
+// SweptCircle class for moving a circle through walls continuously: the step is cut at the
+// earliest time of impact and what is left slides along the wall that was hit, so a fast or
+// diagonal move neither tunnels through a wall nor stops dead against it
+class SweptCircle {
+public:
+    static constexpr int maxSlides = 3;
+    static constexpr float skin = 0.01f; // Gap left at a contact so the next sweep starts clear
+    static constexpr float noImpact = 2.0f;
+
+    // Where a circle at `start` ends up after trying to move by `step`
+    static Vector2 move(Vector2 start, Vector2 step, float radius, const std::vector<const Wall*>& walls) {
+        Vector2 position = start;
+        Vector2 remaining = step;
+        for (int slide = 0; slide < maxSlides && (remaining.x != 0.0f || remaining.y != 0.0f); slide++) {
+            float earliest = noImpact;
+            Vector2 normal = {0.0f, 0.0f};
+            for (const Wall* wall : walls) {
+                Vector2 wallNormal;
+                float t = timeOfImpact(position, remaining, radius, wall->rect, wallNormal);
+                if (t < earliest) {
+                    earliest = t;
+                    normal = wallNormal;
+                }
+            }
+            if (earliest > 1.0f) return VectorUtils::Add(position, remaining);
+
+            position = VectorUtils::Add(position, VectorUtils::Add(VectorUtils::Scale(remaining, earliest), VectorUtils::Scale(normal, skin)));
+            remaining = VectorUtils::Scale(remaining, 1.0f - earliest);
+            float into = VectorUtils::Dot(remaining, normal);
+            if (into < 0.0f) remaining = VectorUtils::Subtract(remaining, VectorUtils::Scale(normal, into));
+        }
+        return position;
+    }
+
+    // Fraction of `delta` at which the circle first touches `rect` (noImpact if it never does)
+    // and the wall normal there. Sweeping a circle against a rect is sweeping its centre point
+    // against the rect grown by the radius with rounded corners: a slab test against the grown
+    // box, then a point-circle test when the entry lands in a corner square.
+    static float timeOfImpact(Vector2 start, Vector2 delta, float radius, const Rectangle& rect, Vector2& normal) {
+        float left = rect.x, right = rect.x + rect.width, top = rect.y, bottom = rect.y + rect.height;
+
+        // Already touching: only moving further in counts, and that stops at once
+        Vector2 closest = {std::min(std::max(start.x, left), right), std::min(std::max(start.y, top), bottom)};
+        Vector2 offset = VectorUtils::Subtract(start, closest);
+        float distanceSq = VectorUtils::Dot(offset, offset);
+        if (distanceSq < radius * radius) {
+            if (distanceSq > 0.0f) {
+                normal = VectorUtils::Scale(offset, 1.0f / sqrtf(distanceSq));
+            } else {
+                // Centre inside the rect: out through the nearest side
+                float toLeft = start.x - left, toRight = right - start.x, toTop = start.y - top, toBottom = bottom - start.y;
+                float nearest = std::min(std::min(toLeft, toRight), std::min(toTop, toBottom));
+                if (nearest == toLeft) normal = {-1.0f, 0.0f};
+                else if (nearest == toRight) normal = {1.0f, 0.0f};
+                else if (nearest == toTop) normal = {0.0f, -1.0f};
+                else normal = {0.0f, 1.0f};
+            }
+            return VectorUtils::Dot(delta, normal) < 0.0f ? 0.0f : noImpact;
+        }
+        if (delta.x == 0.0f && delta.y == 0.0f) return noImpact;
+
+        float enter = 0.0f, exit = 1.0f;
+        Vector2 enterNormal = {0.0f, 0.0f};
+        if (!slab(start.x, delta.x, left - radius, right + radius, {1.0f, 0.0f}, enter, exit, enterNormal)) return noImpact;
+        if (!slab(start.y, delta.y, top - radius, bottom + radius, {0.0f, 1.0f}, enter, exit, enterNormal)) return noImpact;
+
+        Vector2 contact = VectorUtils::Add(start, VectorUtils::Scale(delta, enter));
+        if ((contact.x < left || contact.x > right) && (contact.y < top || contact.y > bottom)) {
+            Vector2 corner = {contact.x < left ? left : right, contact.y < top ? top : bottom};
+            Vector2 fromCorner = VectorUtils::Subtract(start, corner);
+            float a = VectorUtils::Dot(delta, delta);
+            float b = VectorUtils::Dot(fromCorner, delta);
+            float c = VectorUtils::Dot(fromCorner, fromCorner) - radius * radius;
+            float discriminant = b * b - a * c;
+            if (discriminant < 0.0f) return noImpact;
+            float t = (-b - sqrtf(discriminant)) / a;
+            if (t < 0.0f || t > 1.0f) return noImpact;
+            normal = VectorUtils::Normalize(VectorUtils::Subtract(VectorUtils::Add(start, VectorUtils::Scale(delta, t)), corner));
+            return t;
+        }
+        normal = enterNormal;
+        return enter;
+    }
+
+private:
+    // Clip [enter, exit] to where start + t * delta lies in [low, high] on one axis
+    static bool slab(float start, float delta, float low, float high, Vector2 axis, float& enter, float& exit, Vector2& enterNormal) {
+        if (delta == 0.0f) return start >= low && start <= high;
+        float inverse = 1.0f / delta;
+        float entry = (low - start) * inverse, leave = (high - start) * inverse;
+        Vector2 entryNormal = VectorUtils::Scale(axis, -1.0f);
+        if (entry > leave) {
+            std::swap(entry, leave);
+            entryNormal = axis;
+        }
+        if (entry > enter) {
+            enter = entry;
+            enterNormal = entryNormal;
+        }
+        exit = std::min(exit, leave);
+        return enter <= exit;
+    }
+};
+
 // Character class as a base class for Robber and Cop
 class Character {
 public:
@@ -77,14 +300,13 @@ public:
 
     Character(Vector2 pos, int rad, Color col, float spd) : position(pos), radius(rad), color(col), speed(spd) {}
 
-    virtual void draw() {
+    void draw() const {
         DrawCircleV(position, radius, color);
     }
 
-    virtual void move() = 0;
-    virtual void move(Character*, const std::vector<Wall*>&) = 0;
-
-    virtual ~Character() = default; // Virtual destructor
+    void draw(SpriteBatch& batch) const {
+        batch.drawCircle(position, static_cast<float>(radius), color);
+    }
 };
 
 // Robber class inheriting from Character
@@ -92,321 +314,6826 @@ class Robber : public Character {
 public:
     Robber(Vector2 pos, int rad, Color col, float spd) : Character(pos, rad, col, spd) {}
 
-    void move() override {
-        if (IsKeyDown(KEY_W) && position.y - radius > 0) position.y -= speed;
-        if (IsKeyDown(KEY_S) && position.y + radius < GetScreenHeight()) position.y += speed;
-        if (IsKeyDown(KEY_A) && position.x - radius > 0) position.x -= speed;
-        if (IsKeyDown(KEY_D) && position.x + radius < GetScreenWidth()) position.x += speed;
+    // `input` has components in [-1, 1]: the keyboard's, or a RobberBot's
+    void move(Vector2 worldSize, const std::vector<const Wall*>& walls, Vector2 input) {
+        position = SweptCircle::move(position, step(worldSize, input), static_cast<float>(radius), walls);
+    }
+
+    // WASD as an input direction
+    static Vector2 keys() {
+        Vector2 input = {0.0f, 0.0f};
+        if (IsKeyDown(KEY_W)) input.y -= 1.0f;
+        if (IsKeyDown(KEY_S)) input.y += 1.0f;
+        if (IsKeyDown(KEY_A)) input.x -= 1.0f;
+        if (IsKeyDown(KEY_D)) input.x += 1.0f;
+        return input;
     }
 
-    void move(Character* target, const std::vector<Wall*>& walls) override {}
+    // The step `input` asks for, kept inside the world
+    Vector2 step(Vector2 worldSize, Vector2 input) const {
+        Vector2 step = {input.x * speed, input.y * speed};
+        if ((step.y < 0 && position.y - radius <= 0) || (step.y > 0 && position.y + radius >= worldSize.y)) step.y = 0.0f;
+        if ((step.x < 0 && position.x - radius <= 0) || (step.x > 0 && position.x + radius >= worldSize.x)) step.x = 0.0f;
+        return step;
+    }
 };
 
 // Cop class inheriting from Character
 class Cop : public Character {
 public:
+    static constexpr float stuckFraction = 0.1f; // Progress below this share of a step counts as stopped by a wall
+
     float rotation;
+    Vector2 velocity; // Last tick's step; other cops' avoidance assumes it carries on
+
+    Cop(Vector2 pos, int rad, Color col, float spd) : Character(pos, rad, col, spd), rotation(0.0f), velocity({0.0f, 0.0f}) {}
 
-    Cop(Vector2 pos, int rad, Color col, float spd) : Character(pos, rad, col, spd), rotation(0.0f) {}
+    void move(Vector2 aim, const std::vector<const Wall*>& walls, Vector2 worldSize) {
+        advance(steer(aim, walls, worldSize));
+    }
 
-    void move() override {}
+    void advance(Vector2 step) {
+        position = VectorUtils::Add(position, step);
+        velocity = step;
+    }
 
-    void move(Character* target, const std::vector<Wall*>& walls) override {
-        Vector2 direction = VectorUtils::Subtract(target->position, position);
+    // The step this cop would take toward `aim` on its own: along walls and inside the world
+    Vector2 steer(Vector2 aim, const std::vector<const Wall*>& walls, Vector2 worldSize) {
+        Vector2 direction = VectorUtils::Subtract(aim, position);
         direction = VectorUtils::Normalize(direction);
-        Vector2 nextPosition = VectorUtils::Add(position, VectorUtils::Scale(direction, speed));
-
-        // Check for potential collisions and adjust direction
-        for (const Wall* wall : walls) {
-            if (CheckCollisionCircleRec(nextPosition, radius, wall->rect)) {
-                Vector2 perpendicularDirection = { -direction.y, direction.x }; // Perpendicular direction
-                Vector2 nextPosition1 = VectorUtils::Add(position, VectorUtils::Scale(perpendicularDirection, speed));
-                Vector2 nextPosition2 = VectorUtils::Add(position, VectorUtils::Scale(perpendicularDirection, -speed));
-
-                if (!CheckCollisionCircleRec(nextPosition1, radius, wall->rect)) {
-                    nextPosition = nextPosition1;
-                } else if (!CheckCollisionCircleRec(nextPosition2, radius, wall->rect)) {
-                    nextPosition = nextPosition2;
-                } else {
-                    nextPosition = position; // Stay in place if both perpendicular directions are blocked
+        Vector2 nextPosition = SweptCircle::move(position, VectorUtils::Scale(direction, speed), static_cast<float>(radius), walls);
+
+        // Head-on into a wall face there is nothing to slide along: sidestep one way or the other
+        if (VectorUtils::Length(VectorUtils::Subtract(nextPosition, position)) < stuckFraction * speed) {
+            Vector2 side = {-direction.y * speed, direction.x * speed};
+            for (int sign = 1; sign >= -1; sign -= 2) {
+                Vector2 sidestep = SweptCircle::move(position, VectorUtils::Scale(side, static_cast<float>(sign)), static_cast<float>(radius), walls);
+                if (VectorUtils::Length(VectorUtils::Subtract(sidestep, position)) >= stuckFraction * speed) {
+                    nextPosition = sidestep;
+                    break;
                 }
-                break;
             }
         }
 
-        // Ensure cop stays within the screen boundaries
+        // Ensure cop stays within the world boundaries
         if (nextPosition.x - radius < 0) nextPosition.x = radius;
-        if (nextPosition.x + radius > GetScreenWidth()) nextPosition.x = GetScreenWidth() - radius;
+        if (nextPosition.x + radius > worldSize.x) nextPosition.x = worldSize.x - radius;
         if (nextPosition.y - radius < 0) nextPosition.y = radius;
-        if (nextPosition.y + radius > GetScreenHeight()) nextPosition.y = GetScreenHeight() - radius;
-
-        position = nextPosition;
+        if (nextPosition.y + radius > worldSize.y) nextPosition.y = worldSize.y - radius;
 
         // Calculate rotation angle
         rotation = atan2f(direction.y, direction.x) * (180.0f / PI);
+
+        return VectorUtils::Subtract(nextPosition, position);
     }
 
-    void draw() override {
+    void draw() const {
         DrawCircleV(position, radius, color);
         DrawLineEx(position, VectorUtils::Add(position, VectorUtils::Scale({cosf(rotation * (PI / 180.0f)), sinf(rotation * (PI / 180.0f))}, radius)), 2.0f, BLACK);
     }
+
+    void draw(SpriteBatch& batch) const {
+        batch.drawCircle(position, static_cast<float>(radius), color);
+        batch.drawLine(position, VectorUtils::Add(position, VectorUtils::Scale({cosf(rotation * (PI / 180.0f)), sinf(rotation * (PI / 180.0f))}, radius)), 2.0f, BLACK);
+    }
 };
 
-// Coin class inheriting from Object
-class Coin : public Object {
+// Coin class for a collectible
+class Coin {
 public:
     Vector2 position;
-    bool collected;
+    float radius;
 
-    Coin(Vector2 pos) : position(pos), collected(false) {}
+    Coin(Vector2 pos, float rad = 10.0f) : position(pos), radius(rad) {}
 
-    void draw() override {
-        if (!collected) {
-            DrawCircleV(position, 10, GOLD);
-        }
+    void draw() const {
+        DrawCircleV(position, radius, GOLD);
+    }
+
+    void draw(SpriteBatch& batch) const {
+        batch.drawCircle(position, radius, GOLD);
     }
 };
 
-// SlowingZone class inheriting from Object
-class SlowingZone : public Object {
+// SlowingZone class for the area that slows the robber
+class SlowingZone {
 public:
     Rectangle rect;
     float slowEffect;
 
     SlowingZone(Rectangle r, float effect) : rect(r), slowEffect(effect) {}
 
-    void draw() override {
+    void draw() const {
         DrawRectangleRec(rect, Fade(GREEN, 0.5f));
     }
 
-    bool isInside(Vector2 position) {
+    bool isInside(Vector2 position) const {
         return CheckCollisionPointRec(position, rect);
     }
 };
 
-// Game class to run the game
-class Game {
+// Tuning class for the gameplay numbers, read from a `key = value` config file
+class Tuning {
 public:
-    const int screenWidth = 800;
-    const int screenHeight = 600;
-    const int playerRadius = 20;
-    const int copRadius = 20;
-    const int wallThickness = 20;
-    const int targetFPS = 60;
-    const int maxCoins = 5;
-
-    Robber* robber;
-    Cop* cop;
-    Cop* cop2; // Second cop for level 3
-    Door* door; // Door for level 3
-    std::vector<Coin*> coins;
-    std::vector<Wall*> walls;
-    SlowingZone* slowingZone;
-    int score;
-    bool gameOver;
-    bool robberEscaped;
-    int level;
+    float robberSpeed;
+    float copSpeed;
+    float slowEffect;   // Speed multiplier inside a slowing zone
+    int playerRadius;
+    int copRadius;
+    float coinRadius;
+    int maxCoins;
+    Vector2 copSpawn;   // Negative coordinates count back from the right/bottom edge of the world
+    Vector2 cop2Spawn;
+    // Coordinator slot values: what a cop gains by taking each role, less its distance there
+    float chaseValue;
+    float supportValue;
+    float escapeValue;
+    float doorValue;
+    float guardValue;
+
+    Tuning() : robberSpeed(4.5f), copSpeed(3.0f), slowEffect(0.75f), playerRadius(20), copRadius(20), coinRadius(10.0f),
+               maxCoins(5), copSpawn({100.0f, 100.0f}), cop2Spawn({-100.0f, -100.0f}), chaseValue(900.0f), supportValue(150.0f),
+               escapeValue(300.0f), doorValue(450.0f), guardValue(350.0f) {}
 
-    Game() : score(0), gameOver(false), robberEscaped(false), level(1), cop2(nullptr), slowingZone(nullptr), door(nullptr) {
-        InitWindow(screenWidth, screenHeight, "Cop and Robber Game");
-        SetTargetFPS(targetFPS);
-        srand(static_cast<unsigned>(time(0)));
+    // Starts from the defaults, so a key removed from the file goes back to its default.
+    // Returns false (leaving this untouched) if the file can't be read or has a bad line.
+    bool load(const char* path) {
+        FILE* in = fopen(path, "r");
+        if (!in) return false;
 
-        robber = new Robber({screenWidth / 2.0f, screenHeight / 2.0f}, playerRadius, BLUE, 4.5f);
-        cop = new Cop({100.0f, 100.0f}, copRadius, RED, 3.0f);
+        Tuning next;
+        char line[256];
+        int lineNumber = 0;
+        bool ok = true;
+        while (fgets(line, sizeof(line), in)) {
+            lineNumber++;
+            char key[64];
+            char value[128];
+            if (sscanf(line, " %63[^= \t\r\n#] = %127[^\r\n#]", key, value) != 2) {
+                if (sscanf(line, " %63[^ \t\r\n#]", key) == 1) {
+                    TraceLog(LOG_WARNING, "CONFIG: [%s:%d] Expected key = value", path, lineNumber);
+                    ok = false;
+                }
+                continue; // Blank or comment
+            }
+            if (!next.set(key, value)) {
+                TraceLog(LOG_WARNING, "CONFIG: [%s:%d] Bad value for '%s'", path, lineNumber, key);
+                ok = false;
+            }
+        }
+        fclose(in);
 
-        generateCoins();
-        generateWalls();
+        if (ok) *this = next;
+        return ok;
     }
 
-    ~Game() {
-        delete robber;
-        delete cop;
-        delete cop2;
-        delete slowingZone;
-        delete door;
-        for (Coin* coin : coins) delete coin;
-        for (Wall* wall : walls) delete wall;
-        CloseWindow();
+    // Every key, in a file load() reads back
+    bool save(const char* path, const char* comment) const {
+        FILE* out = fopen(path, "w");
+        if (!out) return false;
+        fprintf(out, "# %s\n\n", comment);
+        fprintf(out, "robber_speed = %g\ncop_speed = %g\nslow_effect = %g\n", robberSpeed, copSpeed, slowEffect);
+        fprintf(out, "robber_radius = %d\ncop_radius = %d\ncoin_radius = %g\ncoins_per_level = %d\n", playerRadius, copRadius, coinRadius, maxCoins);
+        fprintf(out, "cop_spawn = %g %g\ncop2_spawn = %g %g\n", copSpawn.x, copSpawn.y, cop2Spawn.x, cop2Spawn.y);
+        fprintf(out, "chase_value = %g\nsupport_value = %g\nescape_value = %g\ndoor_value = %g\nguard_value = %g\n", chaseValue, supportValue, escapeValue, doorValue, guardValue);
+        return fclose(out) == 0;
     }
 
-    void run() {
-        while (!WindowShouldClose()) {
-            update();
-            draw();
-        }
+    Vector2 spawn(Vector2 point, int worldWidth, int worldHeight) const {
+        return {point.x < 0 ? worldWidth + point.x : point.x, point.y < 0 ? worldHeight + point.y : point.y};
     }
 
 private:
-    void update() {
-        if (!gameOver && !robberEscaped) {
-            Vector2 oldPosition = robber->position;
-            robber->move();
+    bool set(const char* key, const char* value) {
+        if (strcmp(key, "robber_speed") == 0) return positive(value, robberSpeed);
+        if (strcmp(key, "cop_speed") == 0) return positive(value, copSpeed);
+        if (strcmp(key, "slow_effect") == 0) return positive(value, slowEffect);
+        if (strcmp(key, "robber_radius") == 0) return positive(value, playerRadius);
+        if (strcmp(key, "cop_radius") == 0) return positive(value, copRadius);
+        if (strcmp(key, "coin_radius") == 0) return positive(value, coinRadius);
+        if (strcmp(key, "coins_per_level") == 0) return positive(value, maxCoins);
+        if (strcmp(key, "cop_spawn") == 0) return sscanf(value, "%f %f", &copSpawn.x, &copSpawn.y) == 2;
+        if (strcmp(key, "cop2_spawn") == 0) return sscanf(value, "%f %f", &cop2Spawn.x, &cop2Spawn.y) == 2;
+        if (strcmp(key, "chase_value") == 0) return nonNegative(value, chaseValue);
+        if (strcmp(key, "support_value") == 0) return nonNegative(value, supportValue);
+        if (strcmp(key, "escape_value") == 0) return nonNegative(value, escapeValue);
+        if (strcmp(key, "door_value") == 0) return nonNegative(value, doorValue);
+        if (strcmp(key, "guard_value") == 0) return nonNegative(value, guardValue);
+        TraceLog(LOG_WARNING, "CONFIG: Unknown key '%s'", key);
+        return true;
+    }
 
-            for (Wall* wall : walls) {
-                if (CheckCollisionCircleRec(robber->position, robber->radius, wall->rect)) {
-                    robber->position = oldPosition;
-                    break;
+    static bool positive(const char* value, float& out) {
+        float parsed;
+        if (sscanf(value, "%f", &parsed) != 1 || parsed <= 0.0f) return false;
+        out = parsed;
+        return true;
+    }
+
+    static bool nonNegative(const char* value, float& out) {
+        float parsed;
+        if (sscanf(value, "%f", &parsed) != 1 || parsed < 0.0f) return false;
+        out = parsed;
+        return true;
+    }
+
+    static bool positive(const char* value, int& out) {
+        int parsed;
+        if (sscanf(value, "%d", &parsed) != 1 || parsed <= 0) return false;
+        out = parsed;
+        return true;
+    }
+};
+
+// FileWatcher class telling the game when a file was rewritten: inotify on the file's directory on
+// Linux (so editors that save via rename are caught), modification-time polling elsewhere
+class FileWatcher {
+public:
+    FileWatcher() : fd(-1), modTime(0), pollCountdown(0) {}
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    ~FileWatcher() {
+#if defined(__linux__)
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    void watch(const std::string& filePath) {
+        path = filePath;
+        size_t slash = path.find_last_of("/\\");
+        name = slash == std::string::npos ? path : path.substr(slash + 1);
+        modTime = FileExists(path.c_str()) ? GetFileModTime(path.c_str()) : 0;
+#if defined(__linux__)
+        std::string dir = slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0 && inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    // Non-blocking; call once per frame
+    bool changed() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            bool hit = false;
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length; p += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(p)->len) {
+                    const inotify_event* event = reinterpret_cast<inotify_event*>(p);
+                    if (event->len > 0 && name == event->name) hit = true;
                 }
             }
+            return hit;
+        }
+#endif
+        if (path.empty() || --pollCountdown > 0) return false;
+        pollCountdown = 30;
+        long current = FileExists(path.c_str()) ? GetFileModTime(path.c_str()) : 0;
+        bool hit = current != modTime;
+        modTime = current;
+        return hit;
+    }
 
-            if (slowingZone && slowingZone->isInside(robber->position)) {
-                robber->speed = 3.375f; // 75% of normal speed
-            } else {
-                robber->speed = 4.5f;
-            }
+private:
+    std::string path;
+    std::string name;
+    int fd;
+    long modTime;
+    int pollCountdown;
+};
 
-            cop->move(robber, walls);
-            if (cop2) cop2->move(robber, walls);
+// FlatArray class for read-only level data that is either owned or borrowed from a mapped level file
+template <typename T>
+class FlatArray {
+public:
+    FlatArray() : items(nullptr), count(0) {}
+    FlatArray(FlatArray&&) = default; // Moving a vector keeps its buffer, so `items` stays valid
+    FlatArray& operator=(FlatArray&&) = default;
+    FlatArray(const FlatArray&) = delete;
+    FlatArray& operator=(const FlatArray&) = delete;
 
-            if (CheckCollisionCircles(robber->position, robber->radius, cop->position, cop->radius) ||
-                (cop2 && CheckCollisionCircles(robber->position, robber->radius, cop2->position, cop2->radius))) {
-                gameOver = true;
-            }
+    void own(std::vector<T>& values) {
+        storage.swap(values);
+        items = storage.data();
+        count = storage.size();
+    }
 
-            for (Coin* coin : coins) {
-                if (!coin->collected && CheckCollisionCircles(robber->position, robber->radius, coin->position, 10)) {
-                    coin->collected = true;
-                    score++;
+    void borrow(const T* values, size_t n) {
+        std::vector<T>().swap(storage);
+        items = values;
+        count = n;
+    }
+
+    const T& operator[](size_t i) const { return items[i]; }
+    const T* data() const { return items; }
+    size_t size() const { return count; }
+
+private:
+    std::vector<T> storage;
+    const T* items;
+    size_t count;
+};
+
+// EntityHandle class for a reference into a Registry that goes stale when its entity is despawned
+class EntityHandle {
+public:
+    uint32_t slot;
+    uint32_t generation;
+
+    EntityHandle() : slot(UINT32_MAX), generation(0) {}
+    EntityHandle(uint32_t s, uint32_t g) : slot(s), generation(g) {}
+};
+
+// Registry class for entities spawned and despawned at runtime. Items are dense (despawn moves
+// the last item into the hole), handles go through a slot table, and each slot's generation
+// changes when it is freed so old handles stop resolving instead of pointing at a newcomer.
+template <typename T>
+class Registry {
+public:
+    EntityHandle spawn(const T& item) {
+        uint32_t slot;
+        if (freeSlots.empty()) {
+            slot = static_cast<uint32_t>(slotItem.size());
+            slotItem.push_back(0);
+            generations.push_back(1);
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        slotItem[slot] = static_cast<uint32_t>(items.size());
+        items.push_back(item);
+        itemSlot.push_back(slot);
+        return EntityHandle(slot, generations[slot]);
+    }
+
+    bool despawn(EntityHandle handle) {
+        if (!get(handle)) return false;
+        uint32_t hole = slotItem[handle.slot];
+        uint32_t last = static_cast<uint32_t>(items.size() - 1);
+        if (hole != last) {
+            items[hole] = items[last];
+            itemSlot[hole] = itemSlot[last];
+            slotItem[itemSlot[hole]] = hole;
+        }
+        items.pop_back();
+        itemSlot.pop_back();
+        release(handle.slot);
+        return true;
+    }
+
+    // Despawn everything. Slots are handed out from 0 again, in order, so a batch spawned after
+    // a clear gets slots matching its position in the batch.
+    void clear() {
+        for (uint32_t slot : itemSlot) generations[slot]++;
+        items.clear();
+        itemSlot.clear();
+        freeSlots.clear();
+        for (uint32_t slot = static_cast<uint32_t>(slotItem.size()); slot-- > 0;) {
+            slotItem[slot] = Free;
+            freeSlots.push_back(slot);
+        }
+    }
+
+    // nullptr for a stale or empty handle
+    T* get(EntityHandle handle) {
+        uint32_t index = find(handle);
+        return index != Free ? &items[index] : nullptr;
+    }
+
+    const T* get(EntityHandle handle) const {
+        uint32_t index = find(handle);
+        return index != Free ? &items[index] : nullptr;
+    }
+
+    // Current handle of whatever lives in `slot`, or an empty handle
+    EntityHandle handleAt(uint32_t slot) const {
+        return slot < slotItem.size() && slotItem[slot] != Free ? EntityHandle(slot, generations[slot]) : EntityHandle();
+    }
+
+    EntityHandle handleOf(size_t index) const { return EntityHandle(itemSlot[index], generations[itemSlot[index]]); }
+    uint32_t slotOf(size_t index) const { return itemSlot[index]; }
+    uint32_t slotCount() const { return static_cast<uint32_t>(slotItem.size()); }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+    typename std::vector<T>::iterator begin() { return items.begin(); }
+    typename std::vector<T>::iterator end() { return items.end(); }
+    typename std::vector<T>::const_iterator begin() const { return items.begin(); }
+    typename std::vector<T>::const_iterator end() const { return items.end(); }
+
+private:
+    enum : uint32_t { Free = UINT32_MAX };
+
+    std::vector<T> items;
+    std::vector<uint32_t> itemSlot;    // Slot of each dense item
+    std::vector<uint32_t> slotItem;    // Dense index of each slot's item, or Free
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeSlots;   // Popped from the back
+
+    // Dense index of the handle's item, or Free when the handle is stale or empty
+    uint32_t find(EntityHandle handle) const {
+        return handle.slot < slotItem.size() && generations[handle.slot] == handle.generation ? slotItem[handle.slot] : Free;
+    }
+
+    void release(uint32_t slot) {
+        slotItem[slot] = Free;
+        generations[slot]++;
+        freeSlots.push_back(slot);
+    }
+};
+
+// NavGrid class for the level's walkable cells and distance fields
+class NavGrid {
+public:
+    float cellSize;
+    int width;
+    int height;
+    FlatArray<uint8_t> blocked;     // 1 where a wall overlaps the cell
+    FlatArray<uint16_t> clearance;  // Steps to the nearest blocked cell or world edge
+
+    NavGrid() : cellSize(1.0f), width(0), height(0) {}
+
+    void build(const std::vector<Wall>& walls, float worldWidth, float worldHeight, float cell) {
+        cellSize = cell;
+        width = static_cast<int>(ceilf(worldWidth / cell));
+        height = static_cast<int>(ceilf(worldHeight / cell));
+        std::vector<uint8_t> cells(width * height, 0);
+
+        // Rasterize each wall straight into its covered cell range
+        for (const Wall& wall : walls) {
+            int x0 = std::max(0, static_cast<int>(floorf(wall.rect.x / cell)));
+            int y0 = std::max(0, static_cast<int>(floorf(wall.rect.y / cell)));
+            int x1 = std::min(width - 1, static_cast<int>(ceilf((wall.rect.x + wall.rect.width) / cell)) - 1);
+            int y1 = std::min(height - 1, static_cast<int>(ceilf((wall.rect.y + wall.rect.height) / cell)) - 1);
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    cells[y * width + x] = 1;
                 }
             }
+        }
 
-            if (score >= maxCoins) {
-                advanceLevel();
-            }
+        blocked.own(cells);
+        buildClearance();
+    }
+
+    // Adopt an occupancy grid that is already in cell form (procedural levels)
+    void buildFromCells(const std::vector<uint8_t>& cells, int cols, int rows, float cell) {
+        cellSize = cell;
+        width = cols;
+        height = rows;
+        std::vector<uint8_t> copy(cells);
+        blocked.own(copy);
+        buildClearance();
+    }
+
+    int cellX(float x) const { return std::min(width - 1, std::max(0, static_cast<int>(x / cellSize))); }
+    int cellY(float y) const { return std::min(height - 1, std::max(0, static_cast<int>(y / cellSize))); }
+    int index(Vector2 p) const { return cellY(p.y) * width + cellX(p.x); }
+
+    bool isBlocked(Vector2 p) const {
+        return blocked[index(p)] != 0;
+    }
+
+    Vector2 cellCenter(int idx) const {
+        return {(idx % width + 0.5f) * cellSize, (idx / width + 0.5f) * cellSize};
+    }
+
+private:
+    // Multi-source BFS from every blocked cell; the world edge counts as one step away
+    void buildClearance() {
+        const uint16_t unset = 0xFFFF;
+        std::vector<uint16_t> distance(width * height, unset);
+        std::vector<int> queue;
+        queue.reserve(width * height);
 
-            if (door && door->isOpen && CheckCollisionCircleRec(robber->position, robber->radius, door->rect)) {
-                robberEscaped = true;
+        for (int i = 0; i < width * height; i++) {
+            if (blocked[i]) {
+                distance[i] = 0;
+                queue.push_back(i);
             }
-        } else {
-            if (IsKeyPressed(KEY_R)) {
-                resetGame();
+        }
+        for (int i = 0; i < width * height; i++) {
+            int x = i % width;
+            int y = i / width;
+            if (distance[i] == unset && (x == 0 || y == 0 || x == width - 1 || y == height - 1)) {
+                distance[i] = 1;
+                queue.push_back(i);
             }
         }
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            int i = queue[head];
+            int x = i % width;
+            int y = i / width;
+            uint16_t next = static_cast<uint16_t>(distance[i] + 1);
+            if (x > 0 && distance[i - 1] == unset) { distance[i - 1] = next; queue.push_back(i - 1); }
+            if (x < width - 1 && distance[i + 1] == unset) { distance[i + 1] = next; queue.push_back(i + 1); }
+            if (y > 0 && distance[i - width] == unset) { distance[i - width] = next; queue.push_back(i - width); }
+            if (y < height - 1 && distance[i + width] == unset) { distance[i + width] = next; queue.push_back(i + width); }
+        }
+
+        clearance.own(distance);
     }
+};
 
-    void draw() {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+// ChokepointFinder class for the narrow passages between the robber's start and what it is
+// after. The cells within sourceDepth steps of the spawn are the source, those within
+// goalDepth of a coin or the door the sink, and every other open cell is split into an in and
+// an out node joined by a unit edge, so Dinic's max flow ends on a minimum vertex cut: the
+// fewest cells that wall the robber in. The graph is never materialized. Arcs come from the
+// grid and a few bytes of flow per cell, which keeps a 1M-cell map in a few MB. Each narrow
+// 8-connected run of cut cells is one chokepoint.
+class ChokepointFinder {
+public:
+    static constexpr int sourceDepth = 6;
+    static constexpr int goalDepth = 3;
+    static constexpr int maxCut = 64;         // A wider cut means open ground, with no chokepoints
+    static constexpr int maxWidth = 8;        // Wider runs of cut cells (a ring round an open spawn) are not passages
+    static constexpr size_t maxChokepoints = 4;
+
+    // Cell centres of the chokepoints, widest first; empty when the cut is wider than maxCut
+    std::vector<Vector2> find(const NavGrid& nav, Vector2 start, const std::vector<Vector2>& goals) {
+        std::vector<Vector2> found;
+        if (nav.width == 0 || nav.isBlocked(start)) return found;
+        grid = &nav;
+        cells = nav.width * nav.height;
+        terminal = 2 * cells;
+        markTerminals(start, goals);
+        if (front.empty()) return found;
 
-        for (Wall* wall : walls) {
-            wall->draw();
+        vertexFlow.assign(cells, 0);
+        edgeFlow.assign(cells, 0);
+        int flow = 0;
+        while (flow <= maxCut && levelGraph()) {
+            std::fill(arc.begin(), arc.end(), 0);
+            flow += blockingFlow(maxCut + 1 - flow);
         }
+        if (flow == 0 || flow > maxCut) return found;
+        return chokepoints();
+    }
+
+private:
+    enum Role : uint8_t { Open, Blocked, Source, Sink };
+
+    const NavGrid* grid;
+    int cells;
+    int terminal;                   // Node id of the sink; cell c is nodes 2c (in) and 2c + 1 (out)
+    int terminalLevel;
+    std::vector<uint8_t> role;
+    std::vector<uint8_t> vertexFlow; // 1 when the cell's in -> out edge carries flow
+    std::vector<uint8_t> edgeFlow;   // Bit d: flow from this cell's out to neighbour d's in
+    std::vector<int> level;
+    std::vector<uint8_t> arc;        // Dinic's current arc per node
+    std::vector<int> front;          // Cells the source touches
+    std::vector<int> queue;
+    std::vector<int> path;
 
-        if (slowingZone) {
-            slowingZone->draw();
+    // Left, right, up, down; d ^ 1 is the opposite direction
+    int neighbour(int cell, int d) const {
+        int x = cell % grid->width;
+        int y = cell / grid->width;
+        switch (d) {
+        case 0: return x > 0 ? cell - 1 : -1;
+        case 1: return x < grid->width - 1 ? cell + 1 : -1;
+        case 2: return y > 0 ? cell - grid->width : -1;
+        default: return y < grid->height - 1 ? cell + grid->width : -1;
         }
+    }
+
+    void markTerminals(Vector2 start, const std::vector<Vector2>& goals) {
+        role.resize(cells);
+        level.assign(2 * cells, -1);
+        arc.assign(2 * cells, 0);
+        for (int c = 0; c < cells; c++) role[c] = grid->blocked[c] ? Blocked : Open;
 
-        for (Coin* coin : coins) {
-            coin->draw();
+        // The source is a BFS ball around the spawn; `level` holds its depths for now
+        queue.clear();
+        int origin = grid->index(start);
+        role[origin] = Source;
+        level[origin] = 0;
+        queue.push_back(origin);
+        for (size_t head = 0; head < queue.size(); head++) {
+            int cell = queue[head];
+            if (level[cell] == sourceDepth) continue;
+            for (int d = 0; d < 4; d++) {
+                int next = neighbour(cell, d);
+                if (next < 0 || role[next] != Open) continue;
+                role[next] = Source;
+                level[next] = level[cell] + 1;
+                queue.push_back(next);
+            }
         }
 
-        if (door) {
-            door->draw();
+        // Each goal is a smaller ball, so the cut is not just the four cells round a coin. A ball
+        // touching the source cannot be cut off, so its cells stay ordinary.
+        std::vector<int> ball;
+        for (const Vector2& goal : goals) {
+            int cell = grid->index(goal);
+            if (role[cell] != Open) continue;
+            ball.assign(1, cell);
+            role[cell] = Sink;
+            level[cell] = 0;
+            bool touchesSource = false;
+            for (size_t head = 0; head < ball.size() && !touchesSource; head++) {
+                for (int d = 0; d < 4; d++) {
+                    int next = neighbour(ball[head], d);
+                    if (next < 0) continue;
+                    touchesSource = touchesSource || role[next] == Source;
+                    if (role[next] != Open || level[ball[head]] == goalDepth) continue;
+                    role[next] = Sink;
+                    level[next] = level[ball[head]] + 1;
+                    ball.push_back(next);
+                }
+            }
+            if (touchesSource) {
+                for (int member : ball) role[member] = Open;
+            }
         }
 
-        robber->draw();
-        cop->draw();
-        if (cop2) cop2->draw();
+        front.clear();
+        for (int cell : queue) {
+            for (int d = 0; d < 4; d++) {
+                int next = neighbour(cell, d);
+                if (next >= 0 && role[next] == Open && !arc[next]) {
+                    arc[next] = 1; // Listed already
+                    front.push_back(next);
+                }
+            }
+        }
+    }
 
-        DrawText(TextFormat("Score: %d", score), 10, 10, 20, BLACK);
-        DrawText(TextFormat("Level: %d", level), 10, 40, 20, BLACK);
+    // Where arc `a` out of `node` leads in the residual graph, or -1. Arc 0 is the cell's own
+    // unit edge (forward from in, backward from out); arcs 1-4 go to the neighbours.
+    int target(int node, int a) const {
+        int cell = node >> 1;
+        if (a == 0) return (node & 1) == vertexFlow[cell] ? node ^ 1 : -1;
+        int d = a - 1;
+        int next = neighbour(cell, d);
+        if (next < 0) return -1;
+        if (node & 1) {
+            if (role[next] == Sink) return terminal;
+            return role[next] == Open ? 2 * next : -1;
+        }
+        // Back along flow the neighbour sent into this cell
+        return role[next] == Open && (edgeFlow[next] >> (d ^ 1) & 1) ? 2 * next + 1 : -1;
+    }
 
-        if (gameOver) {
-            DrawText("Game Over!", screenWidth / 2 - MeasureText("Game Over!", 40) / 2, screenHeight / 2 - 20, 40, RED);
-            DrawText("Press 'R' to restart", screenWidth / 2 - MeasureText("Press 'R' to restart", 20) / 2, screenHeight / 2 + 30, 20, DARKGRAY);
+    void push(int node, int a) {
+        int cell = node >> 1;
+        if (a == 0) {
+            vertexFlow[cell] = (node & 1) ? 0 : 1;
+            return;
+        }
+        int d = a - 1;
+        int next = neighbour(cell, d);
+        if (node & 1) {
+            if (role[next] == Open) edgeFlow[cell] |= static_cast<uint8_t>(1 << d);
+        } else {
+            edgeFlow[next] &= static_cast<uint8_t>(~(1 << (d ^ 1)));
         }
+    }
 
-        if (robberEscaped) {
-            ClearBackground(BLACK);
-            robber->draw();
-            DrawText("We have successfully robbed our neighbour! 😏", screenWidth / 2 - MeasureText("We have successfully robbed our neighbour! 😏", 20) / 2, screenHeight / 2, 20, GREEN);
+    // BFS levels from the source; false once the sink is out of reach
+    bool levelGraph() {
+        std::fill(level.begin(), level.end(), -1);
+        terminalLevel = -1;
+        queue.clear();
+        for (int cell : front) {
+            level[2 * cell] = 1;
+            queue.push_back(2 * cell);
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            int node = queue[head];
+            if (terminalLevel >= 0 && level[node] + 1 >= terminalLevel) continue;
+            for (int a = 0; a < 5; a++) {
+                int next = target(node, a);
+                if (next == terminal) {
+                    terminalLevel = level[node] + 1;
+                } else if (next >= 0 && level[next] < 0) {
+                    level[next] = level[node] + 1;
+                    queue.push_back(next);
+                }
+            }
         }
+        return terminalLevel >= 0;
+    }
 
-        EndDrawing();
+    // Unit augmenting paths along the level graph, walked with an explicit stack since a
+    // path can be as long as the map
+    int blockingFlow(int limit) {
+        int pushed = 0;
+        for (size_t f = 0; f < front.size() && pushed < limit;) {
+            int start = 2 * front[f];
+            if (level[start] != 1) {
+                f++;
+                continue;
+            }
+            path.assign(1, start);
+            while (!path.empty()) {
+                int node = path.back();
+                int next = -1;
+                for (; arc[node] < 5; arc[node]++) {
+                    next = target(node, arc[node]);
+                    if (next == terminal ? level[node] + 1 == terminalLevel : next >= 0 && level[next] == level[node] + 1) break;
+                }
+                if (arc[node] == 5) {
+                    level[node] = -1; // Dead end for the rest of this phase
+                    path.pop_back();
+                    if (!path.empty()) arc[path.back()]++;
+                } else if (next == terminal) {
+                    for (int step : path) push(step, arc[step]);
+                    pushed++;
+                    break;
+                } else {
+                    path.push_back(next);
+                }
+            }
+        }
+        return pushed;
     }
 
-    void generateCoins() {
-        coins.clear();
-        for (int i = 0; i < maxCoins; i++) {
-            Vector2 coinPosition;
-            bool validPosition;
-            do {
-                validPosition = true;
-                coinPosition = {static_cast<float>(rand() % (screenWidth - 2 * 10) + 10),
-                                static_cast<float>(rand() % (screenHeight - 2 * 10) + 10)};
-                for (const Wall* wall : walls) {
-                    if (CheckCollisionPointRec(coinPosition, wall->rect)) {
-                        validPosition = false;
-                        break;
+    // Residual reach from the source, then the cells whose in node is reached and out is not
+    std::vector<Vector2> chokepoints() {
+        levelGraph();
+        std::vector<uint8_t> cut(cells, 0);
+        for (int c = 0; c < cells; c++) cut[c] = role[c] == Open && level[2 * c] >= 0 && level[2 * c + 1] < 0;
+
+        struct Group { int size; Vector2 center; };
+        std::vector<Group> groups;
+        for (int c = 0; c < cells; c++) {
+            if (!cut[c]) continue;
+            queue.assign(1, c);
+            cut[c] = 0;
+            Vector2 sum = {0.0f, 0.0f};
+            for (size_t head = 0; head < queue.size(); head++) {
+                int cell = queue[head];
+                sum = VectorUtils::Add(sum, grid->cellCenter(cell));
+                int x = cell % grid->width;
+                int y = cell / grid->width;
+                for (int ny = std::max(0, y - 1); ny <= std::min(grid->height - 1, y + 1); ny++) {
+                    for (int nx = std::max(0, x - 1); nx <= std::min(grid->width - 1, x + 1); nx++) {
+                        int next = ny * grid->width + nx;
+                        if (cut[next]) {
+                            cut[next] = 0;
+                            queue.push_back(next);
+                        }
                     }
                 }
-            } while (!validPosition);
-            coins.push_back(new Coin(coinPosition));
+            }
+            // The member nearest the mean, so the point is always an open cell
+            Vector2 mean = VectorUtils::Scale(sum, 1.0f / queue.size());
+            Vector2 center = grid->cellCenter(queue[0]);
+            for (int cell : queue) {
+                Vector2 candidate = grid->cellCenter(cell);
+                if (VectorUtils::Length(VectorUtils::Subtract(candidate, mean)) < VectorUtils::Length(VectorUtils::Subtract(center, mean))) center = candidate;
+            }
+            if (queue.size() <= maxWidth) groups.push_back({static_cast<int>(queue.size()), center});
         }
-    }
 
-    void generateWalls() {
-        walls.clear();
-        walls.push_back(new Wall({150.0f, 150.0f, 200.0f, static_cast<float>(wallThickness)}));
-        walls.push_back(new Wall({450.0f, 300.0f, static_cast<float>(wallThickness), 200.0f}));
-        walls.push_back(new Wall({250.0f, 450.0f, 300.0f, static_cast<float>(wallThickness)}));
+        std::stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.size > b.size; });
+        std::vector<Vector2> found;
+        for (size_t i = 0; i < groups.size() && i < maxChokepoints; i++) found.push_back(groups[i].center);
+        return found;
     }
+};
 
-    void generateSlowingZone() {
-        delete slowingZone;
-        float zoneWidth = screenWidth / 2.0f;
-        float zoneHeight = screenHeight / 2.0f;
-        slowingZone = new SlowingZone({static_cast<float>(rand() % (screenWidth - static_cast<int>(zoneWidth))),
-                                       static_cast<float>(rand() % (screenHeight - static_cast<int>(zoneHeight))), 
-                                       zoneWidth, zoneHeight}, 0.75f);
-    }
+// LevelGenerator class for seeded procedural maps on a grid of wall-thickness cells
+class LevelGenerator {
+public:
+    enum Style { Classic, RecursiveDivision, RoomsAndCorridors, CellularCaves };
 
-    void generateDoor() {
-        delete door;
+    int cols;
+    int rows;
+    float cellSize;
+    int passage; // Corridor width in cells
+    Random rng;
+    std::vector<uint8_t> solid;
 
-        door = new Door({screenWidth / 2.0f - 40, screenHeight - 80.0f, 80.0f, 40.0f});
-        door->isOpen = true;
-    }
+    // Valid spawn locations, filled in by place()
+    Vector2 robberSpawn;
+    std::vector<Vector2> copSpawns;
+    std::vector<Vector2> coinSpawns;
+    Vector2 doorCenter;
 
-    void advanceLevel() {
-        level++;
-        score = 0;
-        generateCoins();
+    LevelGenerator(float worldWidth, float worldHeight, float cell, int passageCells, uint64_t seed)
+        : cols(static_cast<int>(worldWidth / cell)), rows(static_cast<int>(worldHeight / cell)),
+          cellSize(cell), passage(passageCells), rng(seed), robberSpawn({0.0f, 0.0f}), doorCenter({0.0f, 0.0f}) {}
 
-        switch (level) {
-            case 2:
-                generateSlowingZone();
-                break;
-            case 3:
-                cop2 = new Cop({screenWidth - 100.0f, screenHeight - 100.0f}, copRadius, PINK, 3.0f);
-                generateDoor();
-                break;
-            default:
-                gameOver = true;
-                break;
+    static const char* styleName(Style style) {
+        switch (style) {
+            case RecursiveDivision: return "division";
+            case RoomsAndCorridors: return "rooms";
+            case CellularCaves: return "caves";
+            default: return "classic";
         }
     }
 
-    void resetGame() {
-        score = 0;
-        level = 1;
-        gameOver = false;
-        robberEscaped = false;
-        delete cop2;
-        cop2 = nullptr;
-        delete slowingZone;
-        slowingZone = nullptr;
-        delete door;
-        door = nullptr;
-        delete cop;
-        cop = new Cop({100.0f, 100.0f}, copRadius, RED, 3.0f);
-        generateCoins();
+    void generate(Style style) {
+        switch (style) {
+            case RecursiveDivision: recursiveDivision(); break;
+            case RoomsAndCorridors: roomsAndCorridors(); break;
+            case CellularCaves: cellularCaves(); break;
+            default: solid.assign(cols * rows, 0); break;
+        }
     }
-};
 
-int main() {
-    Game game;
+    // Merge solid cells into axis-aligned rectangles: horizontal runs per row, extended downwards
+    // while the run below has exactly the same span. Linear in the number of cells.
+    std::vector<Rectangle> mergeWalls() const {
+        std::vector<Rectangle> rects;
+        std::vector<int> above(cols, -1); // Rect index whose run starts at this column in the previous row
+        std::vector<int> current(cols, -1);
+
+        for (int y = 0; y < rows; y++) {
+            std::fill(current.begin(), current.end(), -1);
+            const uint8_t* row = &solid[y * cols];
+            int x = 0;
+            while (x < cols) {
+                if (!row[x]) { x++; continue; }
+                int start = x;
+                while (x < cols && row[x]) x++;
+                float runWidth = (x - start) * cellSize;
+
+                int prev = above[start];
+                if (prev >= 0 && rects[prev].width == runWidth) {
+                    rects[prev].height += cellSize;
+                    current[start] = prev;
+                } else {
+                    rects.push_back({start * cellSize, y * cellSize, runWidth, cellSize});
+                    current[start] = static_cast<int>(rects.size()) - 1;
+                }
+            }
+            above.swap(current);
+        }
+        return rects;
+    }
+
+    // Pick robber, cop, coin and door locations on cells the robber can actually reach.
+    // clearance comes from the NavGrid built over `solid`. Returns false when the map is too
+    // cramped to hold them apart, so the caller can reroll.
+    bool place(const FlatArray<uint16_t>& clearance, int minClearance, int coinCount, int copCount) {
+        copSpawns.clear();
+        coinSpawns.clear();
+
+        // Robber starts on the walkable cell closest to the middle of the map
+        int start = -1;
+        long bestDist = -1;
+        for (int i = 0; i < cols * rows; i++) {
+            if (clearance[i] < minClearance) continue;
+            long dx = i % cols - cols / 2;
+            long dy = i / cols - rows / 2;
+            if (start < 0 || dx * dx + dy * dy < bestDist) {
+                start = i;
+                bestDist = dx * dx + dy * dy;
+            }
+        }
+        if (start < 0) return false;
+
+        std::vector<int> reachable;
+        std::vector<int> distance(cols * rows, -1);
+        distance[start] = 0;
+        reachable.push_back(start);
+        for (size_t head = 0; head < reachable.size(); head++) {
+            int i = reachable[head];
+            int x = i % cols;
+            int y = i / cols;
+            const int next[4] = {x > 0 ? i - 1 : -1, x < cols - 1 ? i + 1 : -1, y > 0 ? i - cols : -1, y < rows - 1 ? i + cols : -1};
+            for (int n : next) {
+                if (n >= 0 && distance[n] < 0 && clearance[n] >= minClearance) {
+                    distance[n] = distance[i] + 1;
+                    reachable.push_back(n);
+                }
+            }
+        }
+
+        // BFS order means the tail of `reachable` is the far end of the map
+        robberSpawn = cellCenter(start);
+        doorCenter = cellCenter(reachable.back());
+        size_t farHalf = reachable.size() / 2;
+        for (int i = 0; i < copCount; i++) {
+            copSpawns.push_back(cellCenter(reachable[farHalf + rng.range(static_cast<int>(reachable.size() - farHalf))]));
+        }
+        for (int i = 0; i < coinCount; i++) {
+            // Never on the robber's own cell unless that is all there is
+            int pick = reachable.size() > 1 ? 1 + rng.range(static_cast<int>(reachable.size()) - 1) : 0;
+            coinSpawns.push_back(cellCenter(reachable[pick]));
+        }
+        return static_cast<int>(reachable.size()) > coinCount + copCount + 1;
+    }
+
+private:
+    Vector2 cellCenter(int i) const {
+        return {(i % cols + 0.5f) * cellSize, (i / cols + 0.5f) * cellSize};
+    }
+
+    void fillRect(int x, int y, int w, int h, uint8_t value) {
+        int x0 = std::max(0, x);
+        int y0 = std::max(0, y);
+        int x1 = std::min(cols, x + w);
+        int y1 = std::min(rows, y + h);
+        for (int cy = y0; cy < y1; cy++) {
+            std::fill(solid.begin() + cy * cols + x0, solid.begin() + cy * cols + x1, value);
+        }
+    }
+
+    // Walls sit on a lattice every (passage + 1) cells; chambers are split with an explicit
+    // stack, so map size is not limited by recursion depth.
+    void recursiveDivision() {
+        const int unit = passage + 1;
+        const int mazeCols = std::max(1, (cols - 1) / unit);
+        const int mazeRows = std::max(1, (rows - 1) / unit);
+        cols = mazeCols * unit + 1;
+        rows = mazeRows * unit + 1;
+        solid.assign(cols * rows, 0);
+        fillRect(0, 0, cols, 1, 1);
+        fillRect(0, rows - 1, cols, 1, 1);
+        fillRect(0, 0, 1, rows, 1);
+        fillRect(cols - 1, 0, 1, rows, 1);
+
+        struct Chamber { int x, y, w, h; };
+        std::vector<Chamber> stack;
+        stack.push_back({0, 0, mazeCols, mazeRows});
+        while (!stack.empty()) {
+            Chamber c = stack.back();
+            stack.pop_back();
+            if (c.w < 2 && c.h < 2) continue;
+
+            bool horizontal = c.h > c.w || (c.h == c.w && (rng.next() & 1));
+            if (c.h < 2) horizontal = false;
+            if (c.w < 2) horizontal = true;
+
+            if (horizontal) {
+                int line = c.y + 1 + rng.range(c.h - 1);
+                int gap = c.x + rng.range(c.w);
+                fillRect(c.x * unit, line * unit, c.w * unit + 1, 1, 1);
+                fillRect(gap * unit + 1, line * unit, passage, 1, 0);
+                stack.push_back({c.x, c.y, c.w, line - c.y});
+                stack.push_back({c.x, line, c.w, c.y + c.h - line});
+            } else {
+                int line = c.x + 1 + rng.range(c.w - 1);
+                int gap = c.y + rng.range(c.h);
+                fillRect(line * unit, c.y * unit, 1, c.h * unit + 1, 1);
+                fillRect(line * unit, gap * unit + 1, 1, passage, 0);
+                stack.push_back({c.x, c.y, line - c.x, c.h});
+                stack.push_back({line, c.y, c.x + c.w - line, c.h});
+            }
+        }
+    }
+
+    // Rooms are placed where the grid is still untouched, then chained in serpentine band order
+    // so every corridor is short and the whole map stays connected.
+    void roomsAndCorridors() {
+        solid.assign(cols * rows, 1);
+        struct Room { int x, y, w, h; };
+        std::vector<Room> rooms;
+        std::vector<uint8_t> used(cols * rows, 0);
+
+        const int minSize = passage + 2;
+        const int maxSize = passage * 3 + 2;
+        const int attempts = cols * rows / (minSize * minSize);
+        for (int i = 0; i < attempts; i++) {
+            Room room = {0, 0, minSize + rng.range(maxSize - minSize + 1), minSize + rng.range(maxSize - minSize + 1)};
+            if (room.w + 2 >= cols || room.h + 2 >= rows) continue;
+            room.x = 1 + rng.range(cols - room.w - 1);
+            room.y = 1 + rng.range(rows - room.h - 1);
+
+            bool free = true;
+            for (int y = room.y - 1; y <= room.y + room.h && free; y++) {
+                for (int x = room.x - 1; x <= room.x + room.w; x++) {
+                    if (used[y * cols + x]) { free = false; break; }
+                }
+            }
+            if (!free) continue;
+
+            for (int y = room.y; y < room.y + room.h; y++) {
+                std::fill(used.begin() + y * cols + room.x, used.begin() + y * cols + room.x + room.w, 1);
+            }
+            fillRect(room.x, room.y, room.w, room.h, 0);
+            rooms.push_back(room);
+        }
+
+        const int band = maxSize * 2;
+        std::sort(rooms.begin(), rooms.end(), [band](const Room& a, const Room& b) {
+            int bandA = a.y / band;
+            int bandB = b.y / band;
+            if (bandA != bandB) return bandA < bandB;
+            return (bandA & 1) ? a.x > b.x : a.x < b.x;
+        });
+
+        for (size_t i = 1; i < rooms.size(); i++) {
+            int ax = rooms[i - 1].x + rooms[i - 1].w / 2;
+            int ay = rooms[i - 1].y + rooms[i - 1].h / 2;
+            int bx = rooms[i].x + rooms[i].w / 2;
+            int by = rooms[i].y + rooms[i].h / 2;
+            int half = passage / 2;
+            fillRect(std::min(ax, bx) - half, ay - half, std::abs(bx - ax) + passage, passage, 0);
+            fillRect(bx - half, std::min(ay, by) - half, passage, std::abs(by - ay) + passage, 0);
+        }
+
+        // Keep a solid rim so nothing leaks off the map
+        fillRect(0, 0, cols, 1, 1);
+        fillRect(0, rows - 1, cols, 1, 1);
+        fillRect(0, 0, 1, rows, 1);
+        fillRect(cols - 1, 0, 1, rows, 1);
+    }
+
+    // Classic 4-5 cellular automaton on a coarse grid (half a corridor per coarse cell),
+    // upsampled so the caves are wide enough for the characters.
+    void cellularCaves() {
+        const int unit = std::max(1, (passage + 1) / 2);
+        const int coarseCols = std::max(3, cols / unit);
+        const int coarseRows = std::max(3, rows / unit);
+        std::vector<uint8_t> cave(coarseCols * coarseRows);
+        std::vector<uint8_t> next(coarseCols * coarseRows);
+
+        for (int y = 0; y < coarseRows; y++) {
+            for (int x = 0; x < coarseCols; x++) {
+                bool edge = x == 0 || y == 0 || x == coarseCols - 1 || y == coarseRows - 1;
+                cave[y * coarseCols + x] = edge || rng.range(100) < 45;
+            }
+        }
+
+        // The rim stays solid, so only the interior is stepped (no bounds checks in the inner loop)
+        next = cave;
+        for (int step = 0; step < 5; step++) {
+            for (int y = 1; y < coarseRows - 1; y++) {
+                const uint8_t* up = &cave[(y - 1) * coarseCols];
+                const uint8_t* mid = &cave[y * coarseCols];
+                const uint8_t* down = &cave[(y + 1) * coarseCols];
+                uint8_t* out = &next[y * coarseCols];
+                for (int x = 1; x < coarseCols - 1; x++) {
+                    int neighbours = up[x - 1] + up[x] + up[x + 1] + mid[x - 1] + mid[x + 1] + down[x - 1] + down[x] + down[x + 1];
+                    out[x] = neighbours > 4 ? 1 : (neighbours < 4 ? 0 : mid[x]);
+                }
+            }
+            cave.swap(next);
+        }
+
+        cols = coarseCols * unit;
+        rows = coarseRows * unit;
+        solid.resize(cols * rows);
+        for (int y = 0; y < rows; y++) {
+            const uint8_t* coarseRow = &cave[(y / unit) * coarseCols];
+            uint8_t* row = &solid[y * cols];
+            for (int x = 0; x < cols; x++) {
+                row[x] = coarseRow[x / unit];
+            }
+        }
+    }
+};
+
+// ChunkGrid class splitting the world into square chunks that index the walls and coins inside them.
+// Only chunks near the robber or a cop are active: coins elsewhere stay out of the broadphase and
+// the influence maps are not propagated there. Collision looks only at the chunks under each
+// character.
+class ChunkGrid {
+public:
+    float chunkSize;
+    int cols;
+    int rows;
+    // Compressed rows: the walls of chunk c are wallItems[wallStart[c] .. wallStart[c + 1])
+    FlatArray<int> wallStart;
+    FlatArray<int> wallItems;
+    FlatArray<int> coinStart;
+    FlatArray<int> coinItems;
+    std::vector<int> active;              // Chunks active this tick
+    std::vector<uint32_t> activeStamp;    // activeStamp[c] == tick when chunk c is in `active`
+    std::vector<uint32_t> wallStamp;      // Per-wall query stamp, so walls spanning chunks come out once
+    uint32_t tick;
+    uint32_t query;
+
+    ChunkGrid() : chunkSize(1.0f), cols(0), rows(0), tick(0), query(0) {}
+
+    void build(const std::vector<Wall>& walls, const std::vector<Coin>& coins, float worldWidth, float worldHeight, float size) {
+        chunkSize = size;
+        cols = std::max(1, static_cast<int>(ceilf(worldWidth / size)));
+        rows = std::max(1, static_cast<int>(ceilf(worldHeight / size)));
+
+        std::vector<Rectangle> wallRects;
+        wallRects.reserve(walls.size());
+        for (const Wall& wall : walls) wallRects.push_back(wall.rect);
+        index(wallRects, wallStart, wallItems);
+
+        // Level coins go into a cleared registry in order, so their index is also their slot
+        std::vector<Rectangle> coinRects;
+        coinRects.reserve(coins.size());
+        for (const Coin& coin : coins) coinRects.push_back({coin.position.x, coin.position.y, 0.0f, 0.0f});
+        index(coinRects, coinStart, coinItems);
+
+        resetState(walls.size());
+    }
+
+    // Rebuild only the coin lists, for coins spawned or moved after the level was built. Items are
+    // registry slots; empty slots are indexed at the origin and skipped when gathered.
+    void indexCoins(const Registry<Coin>& coins) {
+        std::vector<Rectangle> coinRects(coins.slotCount(), Rectangle{0.0f, 0.0f, 0.0f, 0.0f});
+        for (size_t i = 0; i < coins.size(); i++) {
+            coinRects[coins.slotOf(i)] = {coins[i].position.x, coins[i].position.y, 0.0f, 0.0f};
+        }
+        index(coinRects, coinStart, coinItems);
+    }
+
+    // Per-tick bookkeeping; the only part that is not shared with a loaded level file
+    void resetState(size_t wallCount) {
+        active.clear();
+        activeStamp.assign(cols * rows, 0);
+        wallStamp.assign(wallCount, 0);
+        tick = 0;
+        query = 0;
+    }
+
+    void beginTick() {
+        tick++;
+        active.clear();
+    }
+
+    bool isActive(int c) const { return activeStamp[c] == tick; }
+
+    // Activate every chunk within `radius` chunks of a point
+    void activate(Vector2 point, int radius) {
+        int cx = chunkX(point.x);
+        int cy = chunkY(point.y);
+        for (int y = std::max(0, cy - radius); y <= std::min(rows - 1, cy + radius); y++) {
+            for (int x = std::max(0, cx - radius); x <= std::min(cols - 1, cx + radius); x++) {
+                int c = y * cols + x;
+                if (activeStamp[c] != tick) {
+                    activeStamp[c] = tick;
+                    active.push_back(c);
+                }
+            }
+        }
+    }
+
+    // Chunks overlapping `area`
+    void chunksUnder(Rectangle area, std::vector<int>& out) const {
+        out.clear();
+        for (int y = chunkY(area.y); y <= chunkY(area.y + area.height); y++) {
+            for (int x = chunkX(area.x); x <= chunkX(area.x + area.width); x++) {
+                out.push_back(y * cols + x);
+            }
+        }
+    }
+
+    // Collect each wall indexed in the given chunks exactly once
+    void gatherWalls(const std::vector<int>& chunkIds, const std::vector<Wall>& walls, std::vector<const Wall*>& out) {
+        out.clear();
+        query++;
+        for (int c : chunkIds) {
+            for (int i = wallStart[c]; i < wallStart[c + 1]; i++) {
+                int w = wallItems[i];
+                if (wallStamp[w] != query) {
+                    wallStamp[w] = query;
+                    out.push_back(&walls[w]);
+                }
+            }
+        }
+    }
+
+    // Coins are points, so each one lives in exactly one chunk. Collected coins leave their
+    // slot empty and are skipped.
+    void gatherCoins(const std::vector<int>& chunkIds, const Registry<Coin>& coins, std::vector<EntityHandle>& out) const {
+        out.clear();
+        for (int c : chunkIds) {
+            for (int i = coinStart[c]; i < coinStart[c + 1]; i++) {
+                EntityHandle handle = coins.handleAt(static_cast<uint32_t>(coinItems[i]));
+                if (handle.slot != UINT32_MAX) out.push_back(handle);
+            }
+        }
+    }
+
+    int chunkX(float x) const { return std::min(cols - 1, std::max(0, static_cast<int>(x / chunkSize))); }
+    int chunkY(float y) const { return std::min(rows - 1, std::max(0, static_cast<int>(y / chunkSize))); }
+
+private:
+    // Two passes (count, then fill) so each index is one flat array
+    void index(const std::vector<Rectangle>& rects, FlatArray<int>& startOut, FlatArray<int>& itemsOut) const {
+        std::vector<int> start(cols * rows + 1, 0);
+        std::vector<int> items;
+        for (int pass = 0; pass < 2; pass++) {
+            std::vector<int> fill;
+            if (pass == 1) {
+                for (int c = 0; c < cols * rows; c++) start[c + 1] += start[c];
+                items.resize(start[cols * rows]);
+                fill.assign(start.begin(), start.end() - 1);
+            }
+            for (size_t r = 0; r < rects.size(); r++) {
+                const Rectangle& rect = rects[r];
+                for (int y = chunkY(rect.y); y <= chunkY(rect.y + rect.height); y++) {
+                    for (int x = chunkX(rect.x); x <= chunkX(rect.x + rect.width); x++) {
+                        if (pass == 0) start[y * cols + x + 1]++;
+                        else items[fill[y * cols + x]++] = static_cast<int>(r);
+                    }
+                }
+            }
+        }
+        startOut.own(start);
+        itemsOut.own(items);
+    }
+};
+
+// SweepAndPrune class for the character broadphase: circle bounds kept sorted on x across ticks,
+// so the per-tick insertion sort only fixes up what moved, and a sweep along x yields the pairs
+// whose bounds overlap. Proxies are keyed by kind and id (a registry slot) and are dropped
+// when an entity is not updated during a tick.
+class SweepAndPrune {
+public:
+    enum Kind : uint8_t { RobberProxy, CopProxy, CoinProxy, KindCount };
+
+    // Overlapping bounds, with kindA <= kindB
+    struct Pair {
+        Kind kindA;
+        Kind kindB;
+        uint32_t a;
+        uint32_t b;
+    };
+
+    std::vector<Pair> pairs;
+
+    SweepAndPrune() : stamp(0) {}
+
+    void beginTick() {
+        stamp++;
+    }
+
+    void update(Kind kind, uint32_t id, Vector2 center, float radius) {
+        std::vector<int>& lookup = proxyOf[kind];
+        if (id >= lookup.size()) lookup.resize(id + 1, -1);
+        if (lookup[id] < 0) {
+            lookup[id] = static_cast<int>(proxies.size());
+            proxies.push_back({0.0f, 0.0f, 0.0f, 0.0f, id, kind, 0});
+        }
+        Proxy& proxy = proxies[lookup[id]];
+        proxy.minX = center.x - radius;
+        proxy.maxX = center.x + radius;
+        proxy.minY = center.y - radius;
+        proxy.maxY = center.y + radius;
+        proxy.stamp = stamp;
+    }
+
+    // Drop proxies that were not updated, restore x order and collect the overlapping pairs.
+    // Coins never pair with coins.
+    void sweep() {
+        size_t kept = 0;
+        for (size_t i = 0; i < proxies.size(); i++) {
+            if (proxies[i].stamp == stamp) proxies[kept++] = proxies[i];
+            else proxyOf[proxies[i].kind][proxies[i].id] = -1;
+        }
+        proxies.resize(kept);
+
+        // Insertion sort: nearly sorted from last tick, so close to linear
+        for (size_t i = 1; i < proxies.size(); i++) {
+            Proxy moving = proxies[i];
+            size_t j = i;
+            while (j > 0 && proxies[j - 1].minX > moving.minX) {
+                proxies[j] = proxies[j - 1];
+                j--;
+            }
+            proxies[j] = moving;
+        }
+        for (size_t i = 0; i < proxies.size(); i++) proxyOf[proxies[i].kind][proxies[i].id] = static_cast<int>(i);
+
+        pairs.clear();
+        active.clear();
+        for (size_t i = 0; i < proxies.size(); i++) {
+            const Proxy& proxy = proxies[i];
+            size_t live = 0;
+            for (size_t k = 0; k < active.size(); k++) {
+                const Proxy& other = proxies[active[k]];
+                if (other.maxX < proxy.minX) continue;
+                active[live++] = active[k];
+                if (other.minY > proxy.maxY || other.maxY < proxy.minY) continue;
+                if (proxy.kind == CoinProxy && other.kind == CoinProxy) continue;
+                if (proxy.kind <= other.kind) pairs.push_back({proxy.kind, other.kind, proxy.id, other.id});
+                else pairs.push_back({other.kind, proxy.kind, other.id, proxy.id});
+            }
+            active.resize(live);
+            active.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    size_t size() const { return proxies.size(); }
+
+private:
+    struct Proxy {
+        float minX;
+        float maxX;
+        float minY;
+        float maxY;
+        uint32_t id;
+        Kind kind;
+        uint32_t stamp;
+    };
+
+    std::vector<Proxy> proxies;          // Sorted by minX after sweep()
+    std::vector<int> proxyOf[KindCount]; // Proxy index by id, or -1
+    std::vector<uint32_t> active;        // Sweep scratch: proxies whose x interval is still open
+    uint32_t stamp;
+};
+
+// OrcaAvoidance class for reciprocal local avoidance between cops (ORCA, as in van den Berg et
+// al.'s RVO2). Each agent turns every close neighbour into a half-plane of velocities that keep
+// them apart for `timeHorizon` ticks, sharing the effort half each, then takes the allowed
+// velocity nearest its preferred one. Neighbours come from a uniform grid rebuilt per solve and
+// are capped at the closest maxNeighbors. Velocities are in pixels per tick.
+class OrcaAvoidance {
+public:
+    float neighborDistance;
+    int maxNeighbors;
+    float timeHorizon;
+
+    // One entry per agent, filled by the caller before solve()
+    std::vector<Vector2> positions;
+    std::vector<Vector2> velocities;
+    std::vector<Vector2> preferred;
+    std::vector<float> radii;
+    std::vector<float> maxSpeeds;
+    // Written by solve()
+    std::vector<Vector2> out;
+
+    OrcaAvoidance() : neighborDistance(120.0f), maxNeighbors(8), timeHorizon(20.0f), cols(0), rows(0), originX(0.0f), originY(0.0f) {}
+
+    void resize(size_t count) {
+        positions.resize(count);
+        velocities.resize(count);
+        preferred.resize(count);
+        radii.resize(count);
+        maxSpeeds.resize(count);
+    }
+
+    void solve() {
+        size_t count = positions.size();
+        out.resize(count);
+        buildGrid();
+        for (size_t i = 0; i < count; i++) {
+            findNeighbors(i);
+            lines.clear();
+            for (const Neighbor& neighbor : neighbors) {
+                lines.push_back(halfPlane(positions[i], velocities[i], radii[i], positions[neighbor.index], velocities[neighbor.index], radii[neighbor.index]));
+            }
+            Vector2 result = {0.0f, 0.0f};
+            size_t failed = linearProgram2(lines, maxSpeeds[i], preferred[i], false, result);
+            if (failed < lines.size()) linearProgram3(lines, failed, maxSpeeds[i], result);
+            out[i] = result;
+        }
+    }
+
+private:
+    struct Line {
+        Vector2 point;
+        Vector2 direction; // Allowed velocities lie to the left
+    };
+
+    struct Neighbor {
+        float distanceSq;
+        size_t index;
+    };
+
+    int cols;
+    int rows;
+    float originX;
+    float originY;
+    std::vector<int> cellStart; // Agents of cell c are cellItems[cellStart[c] .. cellStart[c + 1])
+    std::vector<int> cellItems;
+    std::vector<int> cellFill;
+    std::vector<Neighbor> neighbors;
+    std::vector<Line> lines;
+    std::vector<Line> projected;
+
+    static float dot(Vector2 a, Vector2 b) { return a.x * b.x + a.y * b.y; }
+    static float det(Vector2 a, Vector2 b) { return a.x * b.y - a.y * b.x; }
+
+    int cellOf(Vector2 p) const {
+        int x = std::min(cols - 1, std::max(0, static_cast<int>((p.x - originX) / neighborDistance)));
+        int y = std::min(rows - 1, std::max(0, static_cast<int>((p.y - originY) / neighborDistance)));
+        return y * cols + x;
+    }
+
+    // Counting sort of the agents into neighborDistance-sized cells
+    void buildGrid() {
+        originX = positions.empty() ? 0.0f : positions[0].x;
+        originY = positions.empty() ? 0.0f : positions[0].y;
+        float maxX = originX;
+        float maxY = originY;
+        for (const Vector2& p : positions) {
+            originX = std::min(originX, p.x);
+            originY = std::min(originY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+        cols = static_cast<int>((maxX - originX) / neighborDistance) + 1;
+        rows = static_cast<int>((maxY - originY) / neighborDistance) + 1;
+        cellStart.assign(cols * rows + 1, 0);
+        for (const Vector2& p : positions) cellStart[cellOf(p) + 1]++;
+        for (int c = 0; c < cols * rows; c++) cellStart[c + 1] += cellStart[c];
+        cellItems.resize(positions.size());
+        cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < positions.size(); i++) cellItems[cellFill[cellOf(positions[i])]++] = static_cast<int>(i);
+    }
+
+    // The closest maxNeighbors agents within neighborDistance, kept sorted by distance
+    void findNeighbors(size_t self) {
+        neighbors.clear();
+        Vector2 p = positions[self];
+        float rangeSq = neighborDistance * neighborDistance;
+        int cell = cellOf(p);
+        int cx = cell % cols;
+        int cy = cell / cols;
+        for (int y = std::max(0, cy - 1); y <= std::min(rows - 1, cy + 1); y++) {
+            for (int x = std::max(0, cx - 1); x <= std::min(cols - 1, cx + 1); x++) {
+                int c = y * cols + x;
+                for (int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                    size_t other = static_cast<size_t>(cellItems[k]);
+                    if (other == self) continue;
+                    Vector2 d = VectorUtils::Subtract(positions[other], p);
+                    float distanceSq = dot(d, d);
+                    if (distanceSq >= rangeSq) continue;
+                    if (static_cast<int>(neighbors.size()) == maxNeighbors) {
+                        if (distanceSq >= neighbors.back().distanceSq) continue;
+                        neighbors.pop_back();
+                    }
+                    size_t at = neighbors.size();
+                    neighbors.push_back({distanceSq, other});
+                    while (at > 0 && neighbors[at - 1].distanceSq > distanceSq) {
+                        neighbors[at] = neighbors[at - 1];
+                        at--;
+                    }
+                    neighbors[at] = {distanceSq, other};
+                }
+            }
+        }
+    }
+
+    // Velocities for agent A that avoid B within the time horizon, assuming B takes half the effort
+    Line halfPlane(Vector2 position, Vector2 velocity, float radius, Vector2 otherPosition, Vector2 otherVelocity, float otherRadius) const {
+        Vector2 relativePosition = VectorUtils::Subtract(otherPosition, position);
+        Vector2 relativeVelocity = VectorUtils::Subtract(velocity, otherVelocity);
+        float distanceSq = dot(relativePosition, relativePosition);
+        float combinedRadius = radius + otherRadius;
+        float combinedRadiusSq = combinedRadius * combinedRadius;
+        Line line;
+        Vector2 u;
+
+        if (distanceSq > combinedRadiusSq) {
+            float invTimeHorizon = 1.0f / timeHorizon;
+            Vector2 w = VectorUtils::Subtract(relativeVelocity, VectorUtils::Scale(relativePosition, invTimeHorizon));
+            float wLengthSq = dot(w, w);
+            float dotProduct = dot(w, relativePosition);
+            if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq) {
+                // Nearest boundary point is on the cut-off circle
+                float wLength = sqrtf(wLengthSq);
+                Vector2 unitW = VectorUtils::Scale(w, 1.0f / wLength);
+                line.direction = {unitW.y, -unitW.x};
+                u = VectorUtils::Scale(unitW, combinedRadius * invTimeHorizon - wLength);
+            } else {
+                // Nearest boundary point is on one of the cone's legs
+                float leg = sqrtf(distanceSq - combinedRadiusSq);
+                if (det(relativePosition, w) > 0.0f) {
+                    line.direction = VectorUtils::Scale({relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                                         relativePosition.x * combinedRadius + relativePosition.y * leg}, 1.0f / distanceSq);
+                } else {
+                    line.direction = VectorUtils::Scale({relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                                         -relativePosition.x * combinedRadius + relativePosition.y * leg}, -1.0f / distanceSq);
+                }
+                u = VectorUtils::Subtract(VectorUtils::Scale(line.direction, dot(relativeVelocity, line.direction)), relativeVelocity);
+            }
+        } else {
+            // Already overlapping: resolve within one tick
+            Vector2 w = VectorUtils::Subtract(relativeVelocity, relativePosition);
+            float wLength = VectorUtils::Length(w);
+            Vector2 unitW = wLength > 0.0f ? VectorUtils::Scale(w, 1.0f / wLength) : Vector2{1.0f, 0.0f};
+            line.direction = {unitW.y, -unitW.x};
+            u = VectorUtils::Scale(unitW, combinedRadius - wLength);
+        }
+
+        line.point = VectorUtils::Add(velocity, VectorUtils::Scale(u, 0.5f));
+        return line;
+    }
+
+    // Best velocity on line `index` within the speed circle and the lines before it
+    static bool linearProgram1(const std::vector<Line>& constraints, size_t index, float radius, Vector2 optimal, bool directionOpt, Vector2& result) {
+        const Line& line = constraints[index];
+        float dotProduct = dot(line.point, line.direction);
+        float discriminant = dotProduct * dotProduct + radius * radius - dot(line.point, line.point);
+        if (discriminant < 0.0f) return false;
+
+        float root = sqrtf(discriminant);
+        float tLeft = -dotProduct - root;
+        float tRight = -dotProduct + root;
+        for (size_t i = 0; i < index; i++) {
+            float denominator = det(line.direction, constraints[i].direction);
+            float numerator = det(constraints[i].direction, VectorUtils::Subtract(line.point, constraints[i].point));
+            if (fabsf(denominator) <= 1e-5f) {
+                if (numerator < 0.0f) return false;
+                continue;
+            }
+            float t = numerator / denominator;
+            if (denominator >= 0.0f) tRight = std::min(tRight, t);
+            else tLeft = std::max(tLeft, t);
+            if (tLeft > tRight) return false;
+        }
+
+        float t;
+        if (directionOpt) {
+            t = dot(optimal, line.direction) > 0.0f ? tRight : tLeft;
+        } else {
+            t = std::min(std::max(dot(line.direction, VectorUtils::Subtract(optimal, line.point)), tLeft), tRight);
+        }
+        result = VectorUtils::Add(line.point, VectorUtils::Scale(line.direction, t));
+        return true;
+    }
+
+    // Velocity nearest `optimal` that satisfies every line; returns the first line it failed on
+    static size_t linearProgram2(const std::vector<Line>& constraints, float radius, Vector2 optimal, bool directionOpt, Vector2& result) {
+        if (directionOpt) {
+            result = VectorUtils::Scale(optimal, radius);
+        } else if (dot(optimal, optimal) > radius * radius) {
+            result = VectorUtils::Scale(VectorUtils::Normalize(optimal), radius);
+        } else {
+            result = optimal;
+        }
+
+        for (size_t i = 0; i < constraints.size(); i++) {
+            if (det(constraints[i].direction, VectorUtils::Subtract(constraints[i].point, result)) > 0.0f) {
+                Vector2 previous = result;
+                if (!linearProgram1(constraints, i, radius, optimal, directionOpt, result)) {
+                    result = previous;
+                    return i;
+                }
+            }
+        }
+        return constraints.size();
+    }
+
+    // Crowded and infeasible: minimise the largest violation instead
+    void linearProgram3(const std::vector<Line>& constraints, size_t begin, float radius, Vector2& result) {
+        float distance = 0.0f;
+        for (size_t i = begin; i < constraints.size(); i++) {
+            if (det(constraints[i].direction, VectorUtils::Subtract(constraints[i].point, result)) <= distance) continue;
+
+            projected.clear();
+            for (size_t j = 0; j < i; j++) {
+                Line line;
+                float determinant = det(constraints[i].direction, constraints[j].direction);
+                if (fabsf(determinant) <= 1e-5f) {
+                    if (dot(constraints[i].direction, constraints[j].direction) > 0.0f) continue;
+                    line.point = VectorUtils::Scale(VectorUtils::Add(constraints[i].point, constraints[j].point), 0.5f);
+                } else {
+                    float t = det(constraints[j].direction, VectorUtils::Subtract(constraints[i].point, constraints[j].point)) / determinant;
+                    line.point = VectorUtils::Add(constraints[i].point, VectorUtils::Scale(constraints[i].direction, t));
+                }
+                line.direction = VectorUtils::Normalize(VectorUtils::Subtract(constraints[j].direction, constraints[i].direction));
+                projected.push_back(line);
+            }
+
+            Vector2 previous = result;
+            if (linearProgram2(projected, radius, {-constraints[i].direction.y, constraints[i].direction.x}, true, result) < projected.size()) {
+                result = previous;
+            }
+            distance = det(constraints[i].direction, VectorUtils::Subtract(constraints[i].point, result));
+        }
+    }
+};
+
+// Pursuit class for where the cops aim. The robber's last few steps give its velocity, and
+// each cop leads it to the closed-form intercept point: the earliest t with
+// |target + velocity * t - cop| = speed * t. A cop whose way there is walled off (the BFS
+// field from the robber's cell runs longer than the straight Manhattan distance, or points
+// away from the lead) walks the field downhill instead. The field only crosses cells with
+// room for a cop, apart from the last few around the robber; it reaches only as far as the
+// cops and is built a slice per tick. The lead is computed for all cops at once over plain
+// float arrays.
+class Pursuit {
+public:
+    static constexpr int historyLength = 8;
+    static constexpr float maxStep = 64.0f;      // A longer jump (respawn, restore) restarts the history
+    static constexpr float horizon = 90.0f;      // Longest lead, in ticks
+    static constexpr uint16_t fieldRange = 256;  // Field depth in cells; cops beyond it aim straight
+    static constexpr int fieldMargin = 2;        // Depth past the farthest cop, for cops that move before a rebuild
+    static constexpr int fieldBudget = 128;      // Cells a field build expands per tick
+    static constexpr int detourSlack = 2;        // Extra cells a path may take and still count as open
+    static constexpr int lookahead = 4;          // Field cells walked per fallback aim
+    static constexpr int escapeDirections = 8;
+    static constexpr uint16_t escapeDepth = 12;  // Field distance of the escape-route cells
+
+    // One entry per cop, filled by the caller before aim()
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> speed;
+    // Written by aim()
+    std::vector<float> aimX;
+    std::vector<float> aimY;
+    // Per compass octant around the robber, a reachable cell escapeDepth steps out, if any
+    Vector2 escapePoints[escapeDirections];
+    bool escapeFound[escapeDirections];
+
+    Pursuit() : head(0), count(0), tracking(false), last({0.0f, 0.0f}) {
+        for (Field* f : {&field, &building}) {
+            f->clearance = 0;
+            f->mark = 0;
+            f->front = 0;
+            f->goalsLeft = 0;
+            f->stopDepth = 0;
+        }
+        reset();
+    }
+
+    // Forget the history and the field, for a new level
+    void reset() {
+        head = 0;
+        count = 0;
+        tracking = false;
+        field.target = -1;
+        building.target = -1;
+        for (bool& found : escapeFound) found = false;
+    }
+
+    // Resume from a snapshot that only kept the average step. The field is dropped too, since
+    // how far a sliced build had got is not in the snapshot
+    void seed(Vector2 target, Vector2 velocity) {
+        for (Vector2& step : steps) step = velocity;
+        head = 0;
+        count = historyLength;
+        tracking = true;
+        last = target;
+        field.target = -1;
+        building.target = -1;
+        for (bool& found : escapeFound) found = false;
+    }
+
+    void resize(size_t cops) {
+        x.resize(cops);
+        y.resize(cops);
+        speed.resize(cops);
+    }
+
+    Vector2 aimOf(size_t cop) const {
+        return {aimX[cop], aimY[cop]};
+    }
+
+    // Record where the target is this tick
+    void observe(Vector2 target) {
+        Vector2 step = VectorUtils::Subtract(target, last);
+        last = target;
+        if (!tracking || fabsf(step.x) > maxStep || fabsf(step.y) > maxStep) {
+            tracking = true;
+            head = 0;
+            count = 0;
+            return;
+        }
+        steps[head] = step;
+        head = (head + 1) % historyLength;
+        if (count < historyLength) count++;
+    }
+
+    // The history fills from steps[0] after every reset, so the first `count` entries are the live ones
+    Vector2 velocity() const {
+        Vector2 sum = {0.0f, 0.0f};
+        for (int i = 0; i < count; i++) sum = VectorUtils::Add(sum, steps[i]);
+        return count > 0 ? VectorUtils::Scale(sum, 1.0f / count) : sum;
+    }
+
+    // `minClearance` is the NavGrid clearance a cell needs for a cop to pass through it
+    void aim(const NavGrid& nav, uint16_t minClearance) {
+        size_t cops = x.size();
+        aimX.resize(cops);
+        aimY.resize(cops);
+        plan(nav, minClearance);
+
+        Vector2 lead = velocity();
+        float leadSq = lead.x * lead.x + lead.y * lead.y;
+        for (size_t i = 0; i < cops; i++) {
+            float dx = last.x - x[i];
+            float dy = last.y - y[i];
+            float a = leadSq - speed[i] * speed[i];
+            float b = dx * lead.x + dy * lead.y;
+            float c = dx * dx + dy * dy;
+            float discriminant = b * b - a * c;
+            float t = (-b - sqrtf(std::max(discriminant, 0.0f))) / a;
+            // No intercept (a faster target running away): aim where it will be at the horizon
+            t = (discriminant >= 0.0f && a != 0.0f && t >= 0.0f) ? (t < horizon ? t : horizon) : horizon;
+            aimX[i] = last.x + lead.x * t;
+            aimY[i] = last.y + lead.y * t;
+        }
+
+        if (field.target < 0) return;
+        int targetX = field.target % nav.width;
+        int targetY = field.target / nav.width;
+        for (size_t i = 0; i < cops; i++) {
+            int cell = onField(nav, nav.index({x[i], y[i]}));
+            if (cell < 0) continue;
+            int cellX = cell % nav.width;
+            int cellY = cell / nav.width;
+            bool open = field.distance[cell] <= abs(cellX - targetX) + abs(cellY - targetY) + detourSlack;
+
+            for (int stepIndex = 0; stepIndex < lookahead && field.distance[cell] > 0; stepIndex++) {
+                cell = downhill(nav, cell);
+            }
+            Vector2 center = nav.cellCenter(cell);
+            // A staircase path can be open while the straight line is not, so the lead also has
+            // to head the same way as the path
+            float along = (center.x - x[i]) * (aimX[i] - x[i]) + (center.y - y[i]) * (aimY[i] - y[i]);
+            if (open && along > 0.0f) continue;
+            aimX[i] = center.x;
+            aimY[i] = center.y;
+        }
+    }
+
+private:
+    // A BFS field out from one cell. Cells are marked with a stamp rather than cleared, so a
+    // build only touches what it reaches.
+    struct Field {
+        int target;           // -1 when there is none
+        uint16_t clearance;
+        uint32_t mark;        // Stamp of the cells this field has reached
+        size_t front;         // Next queue entry to expand
+        int goalsLeft;        // Cops' cells the build has yet to reach
+        int stopDepth;        // Depth the build is cut at
+        std::vector<uint32_t> stamp;
+        std::vector<uint32_t> goalStamp; // Cops' cells not yet reached carry `mark`
+        std::vector<uint16_t> distance;
+        std::vector<int> queue; // In BFS order
+    };
+
+    Vector2 steps[historyLength];
+    int head;
+    int count;
+    bool tracking;
+    Vector2 last;
+    Field field;    // What aim() reads
+    Field building; // Swapped in when it is done; idle while its target is -1
+
+    // Fields are built fieldBudget cells a tick and swapped in when done, so a tick's cost is
+    // bounded however open the map is; the next build starts once the target has left the cell
+    // the field came from. A build stops fieldMargin steps past the last cop (and no nearer
+    // than the escape cells), so its length follows how far away the cops are.
+    void plan(const NavGrid& nav, uint16_t minClearance) {
+        if (nav.width == 0 || !tracking) return;
+        size_t cells = static_cast<size_t>(nav.width) * nav.height;
+        if (field.stamp.size() != cells) {
+            for (Field* f : {&field, &building}) {
+                f->target = -1;
+                f->mark = 0;
+                f->stamp.assign(cells, 0);
+                f->goalStamp.assign(cells, 0);
+                f->distance.resize(cells);
+            }
+        }
+        int cell = nav.index(last);
+        if (building.target < 0 ? cell != field.target || minClearance != field.clearance : minClearance != building.clearance) {
+            start(nav, cell, minClearance);
+        }
+        if (building.target < 0 || !grow(nav)) return;
+        std::swap(field, building);
+        building.target = -1;
+        findEscapes(nav);
+    }
+
+    void start(const NavGrid& nav, int cell, uint16_t minClearance) {
+        Field& f = building;
+        if (++f.mark == 0) {
+            std::fill(f.stamp.begin(), f.stamp.end(), 0);
+            std::fill(f.goalStamp.begin(), f.goalStamp.end(), 0);
+            f.mark = 1;
+        }
+        f.target = cell;
+        f.clearance = minClearance;
+        f.goalsLeft = 0;
+        for (size_t i = 0; i < x.size(); i++) {
+            int goal = nav.index({x[i], y[i]});
+            if (f.goalStamp[goal] != f.mark) {
+                f.goalStamp[goal] = f.mark;
+                f.goalsLeft++;
+            }
+        }
+        f.stopDepth = fieldRange;
+        f.front = 0;
+        f.queue.clear();
+        f.stamp[cell] = f.mark;
+        f.distance[cell] = 0;
+        f.queue.push_back(cell);
+        if (f.goalStamp[cell] == f.mark) {
+            f.goalStamp[cell] = 0;
+            if (--f.goalsLeft == 0) f.stopDepth = cutAt(0);
+        }
+    }
+
+    // Expand up to fieldBudget cells; true once the build is done. A cop's cell counts as
+    // reached once the build touches it, even where the cell is too tight to enter: onField()
+    // then finds the neighbour the field came through.
+    bool grow(const NavGrid& nav) {
+        Field& f = building;
+        uint32_t* stamp = f.stamp.data();
+        uint32_t* goalStamp = f.goalStamp.data();
+        uint16_t* distance = f.distance.data();
+        const uint8_t* blocked = nav.blocked.data();
+        const uint16_t* clearance = nav.clearance.data();
+        for (int budget = fieldBudget; budget > 0 && f.front < f.queue.size(); budget--) {
+            int i = f.queue[f.front++];
+            if (distance[i] >= f.stopDepth) return true;
+            int cx = i % nav.width;
+            int cy = i / nav.width;
+            uint16_t depth = static_cast<uint16_t>(distance[i] + 1);
+            const int neighbours[4] = {cx > 0 ? i - 1 : -1, cx < nav.width - 1 ? i + 1 : -1,
+                                       cy > 0 ? i - nav.width : -1, cy < nav.height - 1 ? i + nav.width : -1};
+            for (int next : neighbours) {
+                if (next < 0) continue;
+                if (goalStamp[next] == f.mark) {
+                    goalStamp[next] = 0;
+                    if (--f.goalsLeft == 0) f.stopDepth = cutAt(depth);
+                }
+                if (stamp[next] == f.mark || blocked[next] || (clearance[next] < f.clearance && depth > f.clearance)) continue;
+                stamp[next] = f.mark;
+                distance[next] = depth;
+                f.queue.push_back(next);
+            }
+        }
+        return f.front == f.queue.size();
+    }
+
+    // Where a build stops once its last cop is `depth` steps out (plain comparisons, so the
+    // constants are not odr-used)
+    static int cutAt(int depth) {
+        int cut = depth + fieldMargin;
+        return cut < escapeDepth ? escapeDepth : (cut > fieldRange ? fieldRange : cut);
+    }
+
+    // The queue is in BFS order, so the cells at escapeDepth are one run of it. Each octant
+    // keeps the one lying closest to its centre line.
+    void findEscapes(const NavGrid& nav) {
+        float bestAlong[escapeDirections];
+        for (int d = 0; d < escapeDirections; d++) {
+            escapeFound[d] = false;
+            bestAlong[d] = -2.0f;
+        }
+        int targetX = field.target % nav.width;
+        int targetY = field.target / nav.width;
+        for (int cell : field.queue) {
+            if (field.distance[cell] < escapeDepth) continue;
+            if (field.distance[cell] > escapeDepth) break;
+            float dx = static_cast<float>(cell % nav.width - targetX);
+            float dy = static_cast<float>(cell / nav.width - targetY);
+            int octant = static_cast<int>(floorf(atan2f(dy, dx) / (PI / 4.0f) + 0.5f));
+            octant = (octant % escapeDirections + escapeDirections) % escapeDirections;
+            float along = (dx * cosf(octant * (PI / 4.0f)) + dy * sinf(octant * (PI / 4.0f))) / sqrtf(dx * dx + dy * dy);
+            if (along > bestAlong[octant]) {
+                bestAlong[octant] = along;
+                escapePoints[octant] = nav.cellCenter(cell);
+                escapeFound[octant] = true;
+            }
+        }
+    }
+
+    // `cell`, or for a cop hugging a wall just off the field, its closest neighbour on it (-1 if none)
+    int onField(const NavGrid& nav, int cell) const {
+        if (field.stamp[cell] == field.mark) return cell;
+        int cx = cell % nav.width;
+        int cy = cell / nav.width;
+        int best = -1;
+        for (int y = std::max(0, cy - 1); y <= std::min(nav.height - 1, cy + 1); y++) {
+            for (int x = std::max(0, cx - 1); x <= std::min(nav.width - 1, cx + 1); x++) {
+                int next = y * nav.width + x;
+                if (field.stamp[next] == field.mark && (best < 0 || field.distance[next] < field.distance[best])) best = next;
+            }
+        }
+        return best;
+    }
+
+    // The neighbour one step closer to the target
+    int downhill(const NavGrid& nav, int cell) const {
+        int cx = cell % nav.width;
+        int cy = cell / nav.width;
+        int neighbours[4] = {cx > 0 ? cell - 1 : -1, cx < nav.width - 1 ? cell + 1 : -1,
+                             cy > 0 ? cell - nav.width : -1, cy < nav.height - 1 ? cell + nav.width : -1};
+        for (int next : neighbours) {
+            if (next >= 0 && field.stamp[next] == field.mark && field.distance[next] < field.distance[cell]) return next;
+        }
+        return cell;
+    }
+};
+
+// Coordinator class for splitting the cops between chasing the robber and cutting it off. The
+// slots are the open door, the robber's escape routes, the level's chokepoints and the lead
+// chase, each held by one cop; every other cop is a support chaser, worth far less, so extra
+// chasers only pile on when nothing better is left. A cop's benefit for a slot is the slot's
+// value minus its distance there (its own intercept point for the chases). An auction solves
+// the assignment with support as every cop's fallback. Prices and the assignment carry over
+// between ticks, and a new tick only re-bids for the cops whose slot is no longer within
+// epsilon of their best, so a steady chase costs one check per cop.
+class Coordinator {
+public:
+    enum : int {
+        DoorSlot = 0,
+        FirstEscape = 1,
+        FirstGuard = FirstEscape + Pursuit::escapeDirections,
+        LeadSlot = FirstGuard + ChokepointFinder::maxChokepoints,
+        SupportSlot,
+        SlotCount = SupportSlot
+    };
+    static constexpr float epsilon = 8.0f;        // Bid increment; the result is within cops * epsilon of optimal
+    static constexpr float headingBonus = 150.0f; // Extra for the route the robber is heading down
+
+    // Slot values, set from Tuning
+    float chaseValue;   // The lead chaser
+    float supportValue; // Every further chaser
+    float escapeValue;
+    float doorValue;
+    float guardValue;
+    // Filled by the caller before assign(): where the door, escape and guard slots are, and which exist
+    Vector2 points[LeadSlot];
+    bool available[LeadSlot];
+    float weights[LeadSlot]; // Scale on the slot's value; 1 unless the caller sets it
+    // Per cop, written by assign()
+    std::vector<int> slotOf;
+
+    Coordinator() {
+        setValues(Tuning());
+        for (int s = 0; s < SlotCount; s++) {
+            if (s < LeadSlot) {
+                points[s] = {0.0f, 0.0f};
+                available[s] = false;
+                weights[s] = 1.0f;
+            }
+            owner[s] = -1;
+            prices[s] = 0.0f;
+            values[s] = 0.0f;
+        }
+    }
+
+    void setValues(const Tuning& tuning) {
+        chaseValue = tuning.chaseValue;
+        supportValue = tuning.supportValue;
+        escapeValue = tuning.escapeValue;
+        doorValue = tuning.doorValue;
+        guardValue = tuning.guardValue;
+    }
+
+    // Cop positions and chase points come from `pursuit` after its aim()
+    void assign(const Pursuit& pursuit, Vector2 target, Vector2 heading) {
+        size_t cops = pursuit.x.size();
+        if (slotOf.size() != cops) {
+            slotOf.assign(cops, -1);
+            for (int s = 0; s < SlotCount; s++) owner[s] = -1;
+        }
+
+        Vector2 direction = VectorUtils::Normalize(heading);
+        values[DoorSlot] = doorValue * weights[DoorSlot];
+        for (int s = FirstEscape; s < FirstGuard; s++) {
+            Vector2 route = VectorUtils::Normalize(VectorUtils::Subtract(points[s], target));
+            values[s] = (escapeValue + headingBonus * VectorUtils::Dot(route, direction)) * weights[s];
+        }
+        for (int s = FirstGuard; s < LeadSlot; s++) values[s] = guardValue * weights[s];
+        values[LeadSlot] = chaseValue;
+
+        // A slot nobody holds is worth its value again; one that closed drops its holder
+        for (int s = 0; s < SlotCount; s++) {
+            if (owner[s] < 0) prices[s] = 0.0f;
+            else if (s < LeadSlot && !available[s]) release(owner[s]);
+        }
+
+        unassigned.clear();
+        for (size_t i = 0; i < cops; i++) {
+            if (slotOf[i] >= 0) {
+                Choice choice = best(pursuit, i);
+                if (net(pursuit, i, slotOf[i]) >= choice.value - epsilon) continue;
+                release(static_cast<int>(i));
+            }
+            unassigned.push_back(static_cast<int>(i));
+        }
+
+        size_t bids = 0;
+        const size_t maxBids = 64 * (cops + SlotCount);
+        while (!unassigned.empty()) {
+            int cop = unassigned.back();
+            unassigned.pop_back();
+            Choice choice = best(pursuit, cop);
+            // Out of bids (only on a pathological tick): whoever is left supports
+            if (choice.slot == SupportSlot || bids++ >= maxBids) {
+                slotOf[cop] = SupportSlot;
+                continue;
+            }
+            prices[choice.slot] += choice.value - choice.second + epsilon;
+            if (owner[choice.slot] >= 0) {
+                unassigned.push_back(owner[choice.slot]);
+                slotOf[owner[choice.slot]] = -1;
+            }
+            owner[choice.slot] = cop;
+            slotOf[cop] = choice.slot;
+        }
+    }
+
+private:
+    struct Choice {
+        int slot;
+        float value;  // Benefit less price of the best slot
+        float second; // The same for the runner-up
+    };
+
+    int owner[SlotCount];
+    float prices[SlotCount];
+    float values[SlotCount];
+    std::vector<int> unassigned;
+
+    // Benefit less price; support has no price, since it never runs out
+    float net(const Pursuit& pursuit, size_t cop, int slot) const {
+        Vector2 from = {pursuit.x[cop], pursuit.y[cop]};
+        Vector2 to = slot >= LeadSlot ? pursuit.aimOf(cop) : points[slot];
+        float distance = VectorUtils::Length(VectorUtils::Subtract(to, from));
+        return slot == SupportSlot ? supportValue - distance : values[slot] - distance - prices[slot];
+    }
+
+    Choice best(const Pursuit& pursuit, size_t cop) const {
+        Choice choice = {SupportSlot, net(pursuit, cop, SupportSlot), -INFINITY};
+        for (int s = 0; s <= LeadSlot; s++) {
+            if (s < LeadSlot && !available[s]) continue;
+            float value = net(pursuit, cop, s);
+            if (value > choice.value) {
+                choice.second = choice.value;
+                choice.value = value;
+                choice.slot = s;
+            } else if (value > choice.second) {
+                choice.second = value;
+            }
+        }
+        return choice;
+    }
+
+    void release(int cop) {
+        if (slotOf[cop] != SupportSlot) owner[slotOf[cop]] = -1;
+        slotOf[cop] = -1;
+    }
+};
+
+// CopNet class for a learned cop policy: a small MLP from per-cop features (where the robber is
+// and where it is going, how open the ground is around the cop, the two nearest cops) to a
+// heading, run for every cop at once as one batch. Activations are kept eight cops to a register,
+// value by value, so each layer is a matrix multiply in which a weight is loaded once per eight
+// cops and is the same for every lane. The first layer is fp32. Later layers may be int8 with a
+// scale per weight row: their inputs come out of a ReLU, so each cop's activations are quantized
+// to 0..127 and two u8*s8 products always fit the 16-bit sums of AVX2's maddubs. The kernels are
+// picked at run time and give the plain loops' results to the bit.
+class CopNet {
+public:
+    enum : uint32_t { Magic = 0x4E4E5243, Version = 1 }; // "CRNN"
+    enum : uint32_t { Linear = 0, Relu = 1 };
+    static constexpr int featureCount = 16;
+    static constexpr int outputCount = 2;   // Heading x, y
+    static constexpr int maxLayers = 4;
+    static constexpr int maxWidth = 256;
+    static constexpr int batch = 8;         // Cops per block: one AVX2 register of fp32 values
+    static constexpr int group = 4;         // int8 inputs packed per cop into one 32-bit lane
+    static constexpr float featureRange = 400.0f; // Offsets are in units of this many pixels
+    static constexpr float neighborRange = 160.0f;
+    static constexpr int sdfCells = 2;      // How far out the clearance samples are taken
+
+    struct Layer {
+        int inputs;
+        int outputs;
+        bool quantized;
+        uint32_t activation;
+        std::vector<float> weights; // One stride()-wide row per output, fp32 layers
+        std::vector<int8_t> packed; // The same for int8 layers
+        std::vector<float> scales;  // Per row of `packed`
+        std::vector<float> bias;
+    };
+
+    std::vector<Layer> layers;
+    bool simd; // AVX2 kernels in use
+
+    CopNet() : simd(hasAvx2()), count(0), cols(0), rows(0), originX(0.0f), originY(0.0f) {
+        for (int d = 0; d < 8; d++) compass[d] = {cosf(d * PI / 4), sinf(d * PI / 4)};
+    }
+
+    // Values per cop in an activation block: whole int8 groups
+    static int padded(int count) { return (count + group - 1) / group * group; }
+
+    // Values per weight row: whole AVX2 registers of the layer's type
+    static int stride(const Layer& layer) {
+        int step = layer.quantized ? 32 : 8;
+        return (layer.inputs + step - 1) / step * step;
+    }
+
+    // Layer widths from the features to the heading; ReLU between layers, and every layer after
+    // the first quantized when `quantize` is set. For benchmarks and as a starting point.
+    void randomize(const std::vector<int>& widths, bool quantize, uint64_t seed) {
+        Random rng(seed);
+        layers.clear();
+        for (size_t l = 0; l + 1 < widths.size(); l++) {
+            Layer layer;
+            layer.inputs = widths[l];
+            layer.outputs = widths[l + 1];
+            layer.quantized = false;
+            layer.activation = l + 2 < widths.size() ? Relu : Linear;
+            layer.weights.assign(static_cast<size_t>(layer.outputs) * stride(layer), 0.0f);
+            layer.bias.assign(layer.outputs, 0.0f);
+            float range = sqrtf(6.0f / layer.inputs);
+            for (int o = 0; o < layer.outputs; o++) {
+                for (int i = 0; i < layer.inputs; i++) layer.weights[o * stride(layer) + i] = (rng.uniform() * 2.0f - 1.0f) * range;
+                layer.bias[o] = (rng.uniform() * 2.0f - 1.0f) * 0.1f;
+            }
+            if (quantize && l > 0) quantizeLayer(layer);
+            layers.push_back(layer);
+        }
+    }
+
+    bool save(const char* path) const {
+        FILE* out = fopen(path, "wb");
+        if (!out) return false;
+        uint32_t header[4] = {Magic, Version, static_cast<uint32_t>(layers.size()), 0};
+        bool ok = fwrite(header, sizeof(header), 1, out) == 1;
+        for (const Layer& layer : layers) {
+            uint32_t shape[4] = {static_cast<uint32_t>(layer.inputs), static_cast<uint32_t>(layer.outputs), layer.quantized ? 1u : 0u, layer.activation};
+            ok = ok && fwrite(shape, sizeof(shape), 1, out) == 1;
+            for (int o = 0; o < layer.outputs && ok; o++) {
+                size_t row = static_cast<size_t>(o) * stride(layer);
+                ok = layer.quantized ? fwrite(&layer.packed[row], 1, layer.inputs, out) == static_cast<size_t>(layer.inputs)
+                                     : fwrite(&layer.weights[row], sizeof(float), layer.inputs, out) == static_cast<size_t>(layer.inputs);
+            }
+            if (layer.quantized) ok = ok && fwrite(layer.scales.data(), sizeof(float), layer.outputs, out) == static_cast<size_t>(layer.outputs);
+            ok = ok && fwrite(layer.bias.data(), sizeof(float), layer.outputs, out) == static_cast<size_t>(layer.outputs);
+        }
+        fclose(out);
+        return ok;
+    }
+
+    // Rejects files whose shapes don't chain from the features to the heading, and int8 layers
+    // that don't follow a ReLU
+    bool load(const char* path) {
+        FILE* in = fopen(path, "rb");
+        if (!in) return false;
+        std::vector<Layer> loaded;
+        uint32_t header[4];
+        bool ok = fread(header, sizeof(header), 1, in) == 1 && header[0] == Magic && header[1] == Version &&
+                  header[2] >= 1 && header[2] <= static_cast<uint32_t>(maxLayers);
+        int inputs = featureCount;
+        uint32_t previous = Linear;
+        for (uint32_t l = 0; ok && l < header[2]; l++) {
+            uint32_t shape[4];
+            ok = fread(shape, sizeof(shape), 1, in) == 1 && static_cast<int>(shape[0]) == inputs && shape[1] >= 1 &&
+                 shape[1] <= static_cast<uint32_t>(maxWidth) && shape[2] <= 1 && shape[3] <= Relu && (shape[2] == 0 || (l > 0 && previous == Relu));
+            if (!ok) break;
+            Layer layer;
+            layer.inputs = inputs;
+            layer.outputs = static_cast<int>(shape[1]);
+            layer.quantized = shape[2] != 0;
+            layer.activation = shape[3];
+            size_t row = stride(layer);
+            if (layer.quantized) layer.packed.assign(layer.outputs * row, 0);
+            else layer.weights.assign(layer.outputs * row, 0.0f);
+            for (int o = 0; o < layer.outputs && ok; o++) {
+                ok = layer.quantized ? fread(&layer.packed[o * row], 1, layer.inputs, in) == static_cast<size_t>(layer.inputs)
+                                     : fread(&layer.weights[o * row], sizeof(float), layer.inputs, in) == static_cast<size_t>(layer.inputs);
+            }
+            if (layer.quantized) {
+                layer.scales.resize(layer.outputs);
+                ok = ok && fread(layer.scales.data(), sizeof(float), layer.outputs, in) == static_cast<size_t>(layer.outputs);
+            }
+            layer.bias.resize(layer.outputs);
+            ok = ok && fread(layer.bias.data(), sizeof(float), layer.outputs, in) == static_cast<size_t>(layer.outputs);
+            loaded.push_back(layer);
+            inputs = layer.outputs;
+            previous = layer.activation;
+        }
+        ok = ok && inputs == outputCount && fgetc(in) == EOF;
+        fclose(in);
+        if (ok) layers.swap(loaded);
+        return ok;
+    }
+
+    // One block of features per `batch` cops in `pursuit`, after its aim(); the last block is
+    // padded with zero cops
+    void gather(const NavGrid& nav, const Pursuit& pursuit, Vector2 robber) {
+        count = pursuit.x.size();
+        size_t blocks = (count + batch - 1) / batch;
+        features.assign(blocks * padded(featureCount) * batch, 0.0f);
+        buildGrid(pursuit);
+        Vector2 lead = pursuit.velocity();
+        float reach = sdfCells * nav.cellSize;
+        float row[featureCount];
+        for (size_t i = 0; i < count; i++) {
+            Vector2 self = {pursuit.x[i], pursuit.y[i]};
+            row[0] = (robber.x - self.x) / featureRange;
+            row[1] = (robber.y - self.y) / featureRange;
+            row[2] = lead.x / pursuit.speed[i];
+            row[3] = lead.y / pursuit.speed[i];
+            for (int d = 0; d < 8; d++) {
+                Vector2 sample = {self.x + compass[d].x * reach, self.y + compass[d].y * reach};
+                bool inside = sample.x >= 0.0f && sample.y >= 0.0f && sample.x < nav.width * nav.cellSize && sample.y < nav.height * nav.cellSize;
+                row[4 + d] = inside ? std::min(nav.clearance[nav.index(sample)], static_cast<uint16_t>(8)) / 8.0f : 0.0f;
+            }
+            nearestTwo(pursuit, i, row + 12);
+            float* block = &features[i / batch * padded(featureCount) * batch + i % batch];
+            for (int f = 0; f < featureCount; f++) block[f * batch] = row[f];
+        }
+    }
+
+    // Headings for the cops gather() saw, into `headings`. Each block of cops goes through every
+    // layer before the next block starts, so its activations never leave L1.
+    void run(std::vector<Vector2>& headings) {
+        size_t blocks = (count + batch - 1) / batch;
+        hidden.assign(padded(maxWidth) * batch, 0.0f);
+        spare.assign(padded(maxWidth) * batch, 0.0f);
+        quantized.assign(padded(maxWidth) / group * batch, 0);
+        headings.resize(count);
+        for (size_t b = 0; b < blocks; b++) {
+            const float* input = &features[b * padded(featureCount) * batch];
+            for (size_t l = 0; l < layers.size(); l++) {
+                const Layer& layer = layers[l];
+                float* output = l % 2 == 0 ? hidden.data() : spare.data();
+                if (layer.quantized) {
+                    if (simd) quantizeAvx2(input, layer.inputs, quantized.data(), steps);
+                    else quantize(input, layer.inputs, quantized.data(), steps);
+                    if (simd) layerI8Avx2(layer, quantized.data(), steps, output);
+                    else layerI8(layer, quantized.data(), steps, output);
+                } else {
+                    if (simd) layerF32Avx2(layer, input, output);
+                    else layerF32(layer, input, output);
+                }
+                input = output;
+            }
+            for (size_t r = b * batch; r < std::min(count, (b + 1) * batch); r++) {
+                headings[r] = VectorUtils::Normalize({input[r % batch], input[batch + r % batch]});
+            }
+        }
+    }
+
+    static bool hasAvx2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
+    }
+
+private:
+    // Activations in blocks of `batch` cops: value v of cop c in block b is at (b * padded + v) * batch + c
+    std::vector<float> features;
+    // One block's activations as it goes through the layers
+    std::vector<float> hidden;
+    std::vector<float> spare;
+    std::vector<uint32_t> quantized; // The int8 layer's input, `group` values per cop in each lane
+    float steps[batch];              // What one count stands for, per cop of the block
+    size_t count;                    // Cops in the batch
+    // Cops bucketed by neighborRange cells, with their positions copied out in bucket order so a
+    // row of neighbouring cells is one run of memory
+    std::vector<int> cellStart;
+    std::vector<int> cellItems;
+    std::vector<int> cellFill;
+    std::vector<float> cellX;
+    std::vector<float> cellY;
+    Vector2 compass[8];
+    int cols;
+    int rows;
+    float originX;
+    float originY;
+
+    static void quantizeLayer(Layer& layer) {
+        std::vector<float> weights;
+        weights.swap(layer.weights);
+        int from = stride(layer);
+        layer.quantized = true;
+        int to = stride(layer);
+        layer.packed.assign(layer.outputs * to, 0);
+        layer.scales.assign(layer.outputs, 0.0f);
+        for (int o = 0; o < layer.outputs; o++) {
+            float largest = 0.0f;
+            for (int i = 0; i < layer.inputs; i++) largest = std::max(largest, fabsf(weights[o * from + i]));
+            layer.scales[o] = largest > 0.0f ? largest / 127.0f : 1.0f;
+            for (int i = 0; i < layer.inputs; i++) layer.packed[o * to + i] = static_cast<int8_t>(lrintf(weights[o * from + i] / layer.scales[o]));
+        }
+    }
+
+    // The kernels below each take one block of `batch` cops.
+
+    // ReLU output to 0..127 per cop, `group` values to a lane, with the step one count stands for
+    static void quantize(const float* in, int inputs, uint32_t* out, float* steps) {
+        for (int i = 0; i < padded(inputs) / group * batch; i++) out[i] = 0;
+        for (int c = 0; c < batch; c++) {
+            float largest = 0.0f;
+            for (int i = 0; i < inputs; i++) largest = std::max(largest, in[i * batch + c]);
+            float step = largest / 127.0f;
+            float inverse = largest > 0.0f ? 1.0f / step : 0.0f;
+            steps[c] = largest > 0.0f ? step : 0.0f;
+            for (int i = 0; i < inputs; i++) {
+                uint32_t value = static_cast<uint32_t>(static_cast<int>(in[i * batch + c] * inverse + 0.5f));
+                out[i / group * batch + c] |= value << (8 * (i % group));
+            }
+        }
+    }
+
+    static void layerF32(const Layer& layer, const float* in, float* out) {
+        for (int o = 0; o < layer.outputs; o++) {
+            const float* w = &layer.weights[static_cast<size_t>(o) * stride(layer)];
+            for (int c = 0; c < batch; c++) {
+                float sum = 0.0f;
+                for (int i = 0; i < layer.inputs; i++) sum += in[i * batch + c] * w[i];
+                out[o * batch + c] = activate(layer, sum + layer.bias[o]);
+            }
+        }
+    }
+
+    static void layerI8(const Layer& layer, const uint32_t* in, const float* steps, float* out) {
+        int groups = padded(layer.inputs) / group;
+        for (int o = 0; o < layer.outputs; o++) {
+            const int8_t* w = &layer.packed[static_cast<size_t>(o) * stride(layer)];
+            for (int c = 0; c < batch; c++) {
+                int32_t sum = 0;
+                for (int i = 0; i < groups * group; i++) sum += static_cast<int32_t>((in[i / group * batch + c] >> (8 * (i % group))) & 0xFF) * w[i];
+                out[o * batch + c] = activate(layer, sum * steps[c] * layer.scales[o] + layer.bias[o]);
+            }
+        }
+    }
+
+    static float activate(const Layer& layer, float value) {
+        return layer.activation == Relu && value < 0.0f ? 0.0f : value;
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __attribute__((target("avx2,fma"))) static void quantizeAvx2(const float* in, int inputs, uint32_t* out, float* steps) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 half = _mm256_set1_ps(0.5f);
+        __m256 largest = zero;
+        for (int i = 0; i < inputs; i++) largest = _mm256_max_ps(largest, _mm256_loadu_ps(in + i * batch));
+        __m256 live = _mm256_cmp_ps(largest, zero, _CMP_GT_OQ);
+        __m256 step = _mm256_div_ps(largest, _mm256_set1_ps(127.0f));
+        __m256 inverse = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), step), live);
+        _mm256_storeu_ps(steps, _mm256_and_ps(step, live));
+        for (int i = 0; i < inputs; i += group) {
+            __m256i packed = _mm256_setzero_si256();
+            for (int k = 0; k < group && i + k < inputs; k++) {
+                // Multiply then add, as the plain loop does, so the counts match it exactly
+                __m256i value = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + (i + k) * batch), inverse), half));
+                packed = _mm256_or_si256(packed, _mm256_slli_epi32(value, 8 * k));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / group * batch), packed);
+        }
+        _mm256_zeroupper();
+    }
+
+    // Four outputs at a time for a block of cops. Products are added rather than fused so the
+    // sums round as the plain loop's do.
+    __attribute__((target("avx2,fma"))) static void layerF32Avx2(const Layer& layer, const float* x, float* y) {
+        size_t row = stride(layer);
+        int o = 0;
+        for (; o + 4 <= layer.outputs; o += 4) {
+            const float* w = &layer.weights[o * row];
+            __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+            for (int i = 0; i < layer.inputs; i++) {
+                __m256 v = _mm256_loadu_ps(x + i * batch);
+                s0 = _mm256_add_ps(s0, _mm256_mul_ps(v, _mm256_broadcast_ss(w + i)));
+                s1 = _mm256_add_ps(s1, _mm256_mul_ps(v, _mm256_broadcast_ss(w + row + i)));
+                s2 = _mm256_add_ps(s2, _mm256_mul_ps(v, _mm256_broadcast_ss(w + 2 * row + i)));
+                s3 = _mm256_add_ps(s3, _mm256_mul_ps(v, _mm256_broadcast_ss(w + 3 * row + i)));
+            }
+            finishAvx2(layer, o, _mm256_set1_ps(1.0f), s0, y + o * batch, false);
+            finishAvx2(layer, o + 1, _mm256_set1_ps(1.0f), s1, y + (o + 1) * batch, false);
+            finishAvx2(layer, o + 2, _mm256_set1_ps(1.0f), s2, y + (o + 2) * batch, false);
+            finishAvx2(layer, o + 3, _mm256_set1_ps(1.0f), s3, y + (o + 3) * batch, false);
+        }
+        for (; o < layer.outputs; o++) {
+            const float* w = &layer.weights[o * row];
+            __m256 sum = _mm256_setzero_ps();
+            for (int i = 0; i < layer.inputs; i++) sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(x + i * batch), _mm256_broadcast_ss(w + i)));
+            finishAvx2(layer, o, _mm256_set1_ps(1.0f), sum, y + o * batch, false);
+        }
+        _mm256_zeroupper(); // The callers are SSE code, and -O1 doesn't add this on its own
+    }
+
+    // Four outputs at a time for a block of cops; each weight lane is the same four inputs of one row
+    __attribute__((target("avx2,fma"))) static void layerI8Avx2(const Layer& layer, const uint32_t* x, const float* steps, float* y) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        int groups = padded(layer.inputs) / group;
+        size_t row = stride(layer);
+        __m256 step = _mm256_loadu_ps(steps);
+        int o = 0;
+        for (; o + 4 <= layer.outputs; o += 4) {
+            const int8_t* w = &layer.packed[o * row];
+            __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256(), s2 = _mm256_setzero_si256(), s3 = _mm256_setzero_si256();
+            for (int g = 0; g < groups; g++) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + g * batch));
+                s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_maddubs_epi16(v, weightGroup(w, g)), ones));
+                s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_maddubs_epi16(v, weightGroup(w + row, g)), ones));
+                s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_maddubs_epi16(v, weightGroup(w + 2 * row, g)), ones));
+                s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_maddubs_epi16(v, weightGroup(w + 3 * row, g)), ones));
+            }
+            finishAvx2(layer, o, step, _mm256_cvtepi32_ps(s0), y + o * batch, true);
+            finishAvx2(layer, o + 1, step, _mm256_cvtepi32_ps(s1), y + (o + 1) * batch, true);
+            finishAvx2(layer, o + 2, step, _mm256_cvtepi32_ps(s2), y + (o + 2) * batch, true);
+            finishAvx2(layer, o + 3, step, _mm256_cvtepi32_ps(s3), y + (o + 3) * batch, true);
+        }
+        for (; o < layer.outputs; o++) {
+            const int8_t* w = &layer.packed[o * row];
+            __m256i sum = _mm256_setzero_si256();
+            for (int g = 0; g < groups; g++) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + g * batch));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(v, weightGroup(w, g)), ones));
+            }
+            finishAvx2(layer, o, step, _mm256_cvtepi32_ps(sum), y + o * batch, true);
+        }
+        _mm256_zeroupper();
+    }
+
+    __attribute__((target("avx2,fma"))) static __m256i weightGroup(const int8_t* row, int g) {
+        int32_t word;
+        memcpy(&word, row + g * group, sizeof(word));
+        return _mm256_set1_epi32(word);
+    }
+
+    // Scale (int8 layers), bias and activation for one output of a block, as the plain loops do them
+    __attribute__((target("avx2,fma"))) static void finishAvx2(const Layer& layer, int o, __m256 step, __m256 sum, float* out, bool scaled) {
+        if (scaled) sum = _mm256_mul_ps(_mm256_mul_ps(sum, step), _mm256_set1_ps(layer.scales[o]));
+        sum = _mm256_add_ps(sum, _mm256_set1_ps(layer.bias[o]));
+        if (layer.activation == Relu) sum = _mm256_and_ps(sum, _mm256_cmp_ps(sum, _mm256_setzero_ps(), _CMP_NLT_UQ));
+        _mm256_storeu_ps(out, sum);
+    }
+#else
+    static void quantizeAvx2(const float* in, int inputs, uint32_t* out, float* steps) { quantize(in, inputs, out, steps); }
+    static void layerF32Avx2(const Layer& layer, const float* in, float* out) { layerF32(layer, in, out); }
+    static void layerI8Avx2(const Layer& layer, const uint32_t* in, const float* steps, float* out) { layerI8(layer, in, steps, out); }
+#endif
+
+    void buildGrid(const Pursuit& pursuit) {
+        size_t count = pursuit.x.size();
+        if (count == 0) return;
+        originX = *std::min_element(pursuit.x.begin(), pursuit.x.end());
+        originY = *std::min_element(pursuit.y.begin(), pursuit.y.end());
+        cols = static_cast<int>((*std::max_element(pursuit.x.begin(), pursuit.x.end()) - originX) / neighborRange) + 1;
+        rows = static_cast<int>((*std::max_element(pursuit.y.begin(), pursuit.y.end()) - originY) / neighborRange) + 1;
+        cellStart.assign(cols * rows + 1, 0);
+        for (size_t i = 0; i < count; i++) cellStart[cellOf(pursuit.x[i], pursuit.y[i]) + 1]++;
+        for (int c = 0; c < cols * rows; c++) cellStart[c + 1] += cellStart[c];
+        cellItems.resize(count);
+        cellX.resize(count);
+        cellY.resize(count);
+        cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < count; i++) {
+            int k = cellFill[cellOf(pursuit.x[i], pursuit.y[i])]++;
+            cellItems[k] = static_cast<int>(i);
+            cellX[k] = pursuit.x[i];
+            cellY[k] = pursuit.y[i];
+        }
+    }
+
+    int cellOf(float x, float y) const {
+        return static_cast<int>((y - originY) / neighborRange) * cols + static_cast<int>((x - originX) / neighborRange);
+    }
+
+    // Offsets to the two nearest cops within neighborRange, nearest first; zero when missing.
+    // About a third of the candidates are in range, in no order a branch predictor can follow, so
+    // the two best are kept with selects. Squared distances are compared by their bits (which
+    // order the same as the values for non-negative floats) so the selects are integer cmovs.
+    void nearestTwo(const Pursuit& pursuit, size_t self, float* out) const {
+        float selfX = pursuit.x[self];
+        float selfY = pursuit.y[self];
+        int32_t best0 = bitsOf(neighborRange * neighborRange);
+        int32_t best1 = best0;
+        int first = -1;
+        int second = -1;
+        int cell = cellOf(selfX, selfY);
+        int cx = cell % cols;
+        int cy = cell / cols;
+        int left = std::max(0, cx - 1);
+        int right = std::min(cols - 1, cx + 1);
+        for (int y = std::max(0, cy - 1); y <= std::min(rows - 1, cy + 1); y++) {
+            for (int k = cellStart[y * cols + left]; k < cellStart[y * cols + right + 1]; k++) {
+                float dx = cellX[k] - selfX;
+                float dy = cellY[k] - selfY;
+                int32_t distanceSq = cellItems[k] == static_cast<int>(self) ? best1 : bitsOf(dx * dx + dy * dy);
+                bool nearest = distanceSq < best0;
+                bool next = distanceSq < best1;
+                best1 = nearest ? best0 : next ? distanceSq : best1;
+                second = nearest ? first : next ? k : second;
+                best0 = nearest ? distanceSq : best0;
+                first = nearest ? k : first;
+            }
+        }
+        out[0] = first < 0 ? 0.0f : (cellX[first] - selfX) / featureRange;
+        out[1] = first < 0 ? 0.0f : (cellY[first] - selfY) / featureRange;
+        out[2] = second < 0 ? 0.0f : (cellX[second] - selfX) / featureRange;
+        out[3] = second < 0 ? 0.0f : (cellY[second] - selfY) / featureRange;
+    }
+
+    static int32_t bitsOf(float value) {
+        int32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+};
+
+// InfluenceMap class for grid fields the AI reads in O(1): where the robber has been lately, how
+// near the cops are and how near the coins are, one value per NavGrid cell. Each tick every
+// layer takes the larger of a cell's value and `spread` times its best neighbour, times `decay`,
+// and then its sources are stamped back to 1. A source's value falls by decay * spread per step
+// through open cells (the steps a BFS would count) and fades by `decay` per tick once the source
+// moves on. Values are 16-bit fixed point, so the kernel moves half the bytes floats would and
+// works sixteen cells at a time on AVX2 (picked at run time, bit for bit the scalar loop's
+// result); rounding down also lets a fading value reach zero. Layers carry a border of zero
+// cells so the kernel has no edge checks. Only the ChunkGrid's active chunks are propagated, as
+// runs along each chunk row. A chunk that drops out has its robber and cop values cleared, as
+// the trail there would otherwise stay frozen rather than fade, and its coin values copied
+// across, so both buffers of a layer match outside the active chunks and can still be swapped
+// every tick. The coin layer is settled over the whole grid when the map is built (on the level
+// build worker), so passages far from any activity still know how near the coins are.
+class InfluenceMap {
+public:
+    enum Layer { RobberPresence, CopCoverage, CoinValue, LayerCount };
+    static constexpr uint16_t one = 0xFFFF;
+
+    bool simd; // AVX2 kernel in use
+
+    InfluenceMap() : simd(CopNet::hasAvx2()), width(0), height(0), stride(0), cellSize(1.0f) {
+        // The robber's trail lingers for a couple of seconds; cops and coins are stamped every tick
+        setRates(RobberPresence, 0.98f, 0.85f);
+        setRates(CopCoverage, 0.9f, 0.8f);
+        setRates(CoinValue, 0.9f, 0.9f);
+    }
+
+    // Size the layers for `nav`: the robber and cop layers zero, the coin layer settled around `coins`
+    template <typename Coins>
+    void build(const NavGrid& nav, const Coins& coins) {
+        width = nav.width;
+        height = nav.height;
+        stride = width + 2;
+        cellSize = nav.cellSize;
+        size_t padded = static_cast<size_t>(stride) * (height + 2);
+        open.assign(padded, 0);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) open[(y + 1) * stride + x + 1] = nav.blocked[y * width + x] ? 0 : one;
+        }
+        for (int l = 0; l < LayerCount; l++) {
+            layers[l].assign(padded, 0);
+            back[l].assign(padded, 0);
+        }
+        wasActive.clear();
+
+        // A value is gone within a few dozen steps, so this stops long before the cap
+        Span all = {0, width, 0, height};
+        for (const Coin& coin : coins) layers[CoinValue][paddedIndex(coin.position)] = one;
+        for (int pass = 0; pass < settlePasses; pass++) {
+            propagate(CoinValue, all);
+            for (const Coin& coin : coins) back[CoinValue][paddedIndex(coin.position)] = one;
+            bool done = back[CoinValue] == layers[CoinValue];
+            layers[CoinValue].swap(back[CoinValue]);
+            if (done) break;
+        }
+        back[CoinValue] = layers[CoinValue];
+        settled = layers[CoinValue];
+        settledCoins.clear();
+        for (const Coin& coin : coins) settledCoins.push_back(coin.position);
+    }
+
+    // As build on the same nav, for a state restore: the settled coin layer is reused when the
+    // coins are the ones it was settled around, so only a changed coin set pays for the settle
+    template <typename Coins>
+    void rebuild(const NavGrid& nav, const Coins& coins) {
+        size_t same = 0;
+        for (const Coin& coin : coins) {
+            if (same == settledCoins.size() || coin.position.x != settledCoins[same].x || coin.position.y != settledCoins[same].y) break;
+            same++;
+        }
+        if (width != nav.width || height != nav.height || same != settledCoins.size() || same != coins.size()) {
+            build(nav, coins);
+            return;
+        }
+        for (int l = 0; l < LayerCount; l++) {
+            if (l == CoinValue) continue;
+            std::fill(layers[l].begin(), layers[l].end(), 0);
+            std::fill(back[l].begin(), back[l].end(), 0);
+        }
+        layers[CoinValue] = settled;
+        back[CoinValue] = settled;
+        wasActive.clear();
+    }
+
+    // Propagate the chunks `chunks` has active this tick, then stamp the sources. The robber and
+    // the cops are always in active chunks; coins may not be, so theirs go into both buffers.
+    void update(const ChunkGrid& chunks, Vector2 robber, const Registry<Cop>& cops, const Registry<Coin>& coins) {
+        if (width == 0) return;
+        findSpans(chunks);
+        for (int l = 0; l < LayerCount; l++) {
+            for (const Span& span : retired) {
+                for (int y = span.y0 + 1; y <= span.y1; y++) {
+                    size_t first = static_cast<size_t>(y) * stride + span.x0 + 1;
+                    size_t bytes = (span.x1 - span.x0) * sizeof(uint16_t);
+                    if (l == CoinValue) {
+                        memcpy(&back[l][first], &layers[l][first], bytes);
+                    } else {
+                        memset(&layers[l][first], 0, bytes);
+                        memset(&back[l][first], 0, bytes);
+                    }
+                }
+            }
+            for (const Span& span : spans) propagate(static_cast<Layer>(l), span);
+            layers[l].swap(back[l]);
+        }
+        layers[RobberPresence][paddedIndex(robber)] = one;
+        for (const Cop& cop : cops) layers[CopCoverage][paddedIndex(cop.position)] = one;
+        for (const Coin& coin : coins) {
+            layers[CoinValue][paddedIndex(coin.position)] = one;
+            back[CoinValue][paddedIndex(coin.position)] = one;
+        }
+    }
+
+    // Cells propagated last update
+    size_t activeCells() const {
+        size_t cells = 0;
+        for (const Span& span : spans) cells += static_cast<size_t>(span.x1 - span.x0) * (span.y1 - span.y0);
+        return cells;
+    }
+
+    // In [0, 1], by NavGrid cell index
+    float at(Layer layer, int cell) const {
+        return layers[layer][(cell / width + 1) * stride + cell % width + 1] * (1.0f / one);
+    }
+
+    float at(Layer layer, Vector2 p) const {
+        return width == 0 ? 0.0f : layers[layer][paddedIndex(p)] * (1.0f / one);
+    }
+
+    // What a value drops by per step from its source once the layer has settled
+    float falloff(Layer layer) const {
+        return (decay[layer] / 65536.0f) * (spread[layer] / 65536.0f);
+    }
+
+    // Cells [x0, x1) x [y0, y1), unpadded
+    struct Span {
+        int x0;
+        int x1;
+        int y0;
+        int y1;
+    };
+
+    // `decay` and `spread` are 16-bit fractions of 1
+    static void propagate(const uint16_t* in, const uint16_t* open, uint16_t* out, int stride, Span span, uint16_t decay, uint16_t spread) {
+        for (int y = span.y0 + 1; y <= span.y1; y++) {
+            const uint16_t* row = in + y * stride;
+            const uint16_t* up = row - stride;
+            const uint16_t* down = row + stride;
+            const uint16_t* mask = open + y * stride;
+            uint16_t* result = out + y * stride;
+            for (int x = span.x0 + 1; x <= span.x1; x++) result[x] = cell(row, up, down, mask, x, decay, spread);
+        }
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __attribute__((target("avx2,fma"))) static void propagateAvx2(const uint16_t* in, const uint16_t* open, uint16_t* out, int stride, Span span, uint16_t decay, uint16_t spread) {
+        const __m256i decays = _mm256_set1_epi16(static_cast<short>(decay));
+        const __m256i spreads = _mm256_set1_epi16(static_cast<short>(spread));
+        for (int y = span.y0 + 1; y <= span.y1; y++) {
+            const uint16_t* row = in + y * stride;
+            const uint16_t* up = row - stride;
+            const uint16_t* down = row + stride;
+            const uint16_t* mask = open + y * stride;
+            uint16_t* result = out + y * stride;
+            int x = span.x0 + 1;
+            for (; x + 16 <= span.x1 + 1; x += 16) {
+                __m256i neighbour = _mm256_max_epu16(_mm256_max_epu16(load(row + x - 1), load(row + x + 1)), _mm256_max_epu16(load(up + x), load(down + x)));
+                __m256i value = _mm256_mulhi_epu16(_mm256_max_epu16(load(row + x), _mm256_mulhi_epu16(neighbour, spreads)), decays);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + x), _mm256_and_si256(value, load(mask + x)));
+            }
+            for (; x <= span.x1; x++) result[x] = cell(row, up, down, mask, x, decay, spread);
+        }
+        _mm256_zeroupper();
+    }
+
+    __attribute__((target("avx2,fma"))) static __m256i load(const uint16_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+#else
+    static void propagateAvx2(const uint16_t* in, const uint16_t* open, uint16_t* out, int stride, Span span, uint16_t decay, uint16_t spread) { propagate(in, open, out, stride, span, decay, spread); }
+#endif
+
+private:
+    int width;
+    int height;
+    int stride; // width plus the border on both sides
+    float cellSize;
+    uint16_t decay[LayerCount];
+    uint16_t spread[LayerCount];
+    std::vector<uint16_t> layers[LayerCount];
+    std::vector<uint16_t> back[LayerCount]; // What each layer is propagated into before the swap
+    std::vector<uint16_t> open; // `one` on cells that are not blocked, 0 on walls and the border
+    std::vector<uint16_t> settled;     // The coin layer as build left it
+    std::vector<Vector2> settledCoins; // The coins it was settled around, in order
+    std::vector<Span> spans;    // The active chunks, a run of them per span
+    std::vector<Span> retired;  // Chunks active last update and not this one
+    std::vector<uint8_t> wasActive; // Per chunk, as of the last update
+    static constexpr int settlePasses = 256;
+
+    // One layer's span, into its back buffer
+    void propagate(Layer layer, Span span) {
+        if (simd) propagateAvx2(layers[layer].data(), open.data(), back[layer].data(), stride, span, decay[layer], spread[layer]);
+        else propagate(layers[layer].data(), open.data(), back[layer].data(), stride, span, decay[layer], spread[layer]);
+    }
+
+    void findSpans(const ChunkGrid& chunks) {
+        wasActive.resize(static_cast<size_t>(chunks.cols) * chunks.rows, 0);
+        collectSpans(chunks, [&](int c) { return chunks.isActive(c); }, spans);
+        collectSpans(chunks, [&](int c) { return wasActive[c] && !chunks.isActive(c); }, retired);
+        for (int c = 0; c < chunks.cols * chunks.rows; c++) wasActive[c] = chunks.isActive(c);
+    }
+
+    // Runs of the chunks `pick` takes along each chunk row, in cells
+    template <typename Pick>
+    void collectSpans(const ChunkGrid& chunks, Pick pick, std::vector<Span>& out) const {
+        out.clear();
+        for (int cy = 0; cy < chunks.rows; cy++) {
+            for (int cx = 0; cx < chunks.cols; cx++) {
+                if (!pick(cy * chunks.cols + cx)) continue;
+                int end = cx + 1;
+                while (end < chunks.cols && pick(cy * chunks.cols + end)) end++;
+                Span span = {cellEdge(cx * chunks.chunkSize, width), cellEdge(end * chunks.chunkSize, width),
+                             cellEdge(cy * chunks.chunkSize, height), cellEdge((cy + 1) * chunks.chunkSize, height)};
+                if (span.x0 < span.x1 && span.y0 < span.y1) out.push_back(span);
+                cx = end;
+            }
+        }
+    }
+
+    // The first cell at or past world coordinate `p`, up to `limit`; chunk edges through the
+    // middle of a cell give it to the chunk on the right (or below)
+    int cellEdge(float p, int limit) const {
+        return std::min(limit, static_cast<int>(p / cellSize));
+    }
+
+    void setRates(Layer layer, float layerDecay, float layerSpread) {
+        decay[layer] = static_cast<uint16_t>(layerDecay * 65536.0f);
+        spread[layer] = static_cast<uint16_t>(layerSpread * 65536.0f);
+    }
+
+    // The products keep the high half, as _mm256_mulhi_epu16 does
+    static uint16_t cell(const uint16_t* row, const uint16_t* up, const uint16_t* down, const uint16_t* mask, int x, uint16_t decay, uint16_t spread) {
+        uint16_t neighbour = std::max(std::max(row[x - 1], row[x + 1]), std::max(up[x], down[x]));
+        uint16_t spreadOut = static_cast<uint16_t>((static_cast<uint32_t>(neighbour) * spread) >> 16);
+        uint16_t value = static_cast<uint16_t>((static_cast<uint32_t>(std::max(row[x], spreadOut)) * decay) >> 16);
+        return value & mask[x];
+    }
+
+    // As NavGrid::index, into the bordered layers
+    int paddedIndex(Vector2 p) const {
+        int x = std::min(width - 1, std::max(0, static_cast<int>(p.x / cellSize)));
+        int y = std::min(height - 1, std::max(0, static_cast<int>(p.y / cellSize)));
+        return (y + 1) * stride + x + 1;
+    }
+};
+
+// RobberBot class for a robber that plays itself, for soak runs and the headless benchmarks.
+// It visits the coins in a nearest-neighbour tour tightened by 2-opt, walking down a BFS field
+// from the next coin, and keeps out of the steps from the nearest cop that the InfluenceMap's
+// cop layer stands for. The coin field is stamped and only rebuilt when the target changes, so
+// a decision is a look at nine cells.
+class RobberBot {
+public:
+    static constexpr int dangerDepth = 6;    // Steps from a cop the robber starts to give way
+    static constexpr int dangerWeight = 4;   // Goal steps one step closer to a cop is worth
+    static constexpr int maxPasses = 8;      // 2-opt sweeps per tour
+
+    RobberBot() : next(0), goalCell(-1), goalStamp(0) {}
+
+    // Drop the tour and the coin field: a new level or a restored state
+    void reset() {
+        tour.clear();
+        next = 0;
+        goalCell = -1;
+    }
+
+    // A direction with components in [-1, 1] for Robber::move
+    Vector2 steer(const NavGrid& nav, Vector2 robber, float radius, const Registry<Coin>& coins, const InfluenceMap& influence) {
+        size_t cells = static_cast<size_t>(nav.width) * nav.height;
+        if (cells == 0 || coins.empty()) return {0.0f, 0.0f};
+        if (goalSeen.size() != cells) {
+            goalSeen.assign(cells, 0);
+            goal.resize(cells);
+            reset();
+        }
+
+        const Coin* target = nullptr;
+        while (next < tour.size() && !(target = coins.get(tour[next]))) next++;
+        if (!target) {
+            plan(robber, coins);
+            target = coins.get(tour[next]);
+        }
+        uint16_t need = static_cast<uint16_t>(1 + ceilf(radius / nav.cellSize));
+        if (nav.index(target->position) != goalCell) fillGoal(nav, nav.index(target->position), need);
+        float stepLog = 1.0f / logf(influence.falloff(InfluenceMap::CopCoverage));
+
+        // The neighbour (or this cell) with the fewest goal steps plus the danger it is in
+        int here = nav.index(robber);
+        int hx = here % nav.width;
+        int hy = here / nav.width;
+        int best = -1;
+        int bestCost = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int x = hx + dx;
+                int y = hy + dy;
+                if (x < 0 || y < 0 || x >= nav.width || y >= nav.height) continue;
+                int cell = y * nav.width + x;
+                if (goalSeen[cell] != goalStamp) continue;
+                if (dx != 0 && dy != 0 && (goalSeen[here + dx] != goalStamp || goalSeen[here + dy * nav.width] != goalStamp)) continue;
+                int cost = goal[cell];
+                float near = influence.at(InfluenceMap::CopCoverage, cell);
+                int steps = near > 0.0f ? static_cast<int>(lrintf(logf(near) * stepLog)) : dangerDepth + 1;
+                if (steps <= dangerDepth) cost += dangerWeight * (dangerDepth + 1 - steps);
+                if (best < 0 || cost < bestCost) {
+                    best = cell;
+                    bestCost = cost;
+                }
+            }
+        }
+        Vector2 toward = best < 0 || best == here ? target->position : nav.cellCenter(best);
+        Vector2 offset = VectorUtils::Subtract(toward, robber);
+        if (VectorUtils::Length(offset) < 1.0f) return {0.0f, 0.0f};
+        return VectorUtils::Normalize(offset);
+    }
+
+private:
+    std::vector<EntityHandle> tour;
+    size_t next; // First tour stop not yet known to be collected
+    std::vector<uint32_t> goalSeen;
+    std::vector<uint16_t> goal;   // Steps to the target coin
+    std::vector<int> queue;
+    int goalCell;
+    uint32_t goalStamp;
+
+    // Nearest neighbour from the robber, then 2-opt on the open path (the start stays first)
+    void plan(Vector2 robber, const Registry<Coin>& coins) {
+        std::vector<Vector2> stops(1, robber);
+        tour.clear();
+        std::vector<EntityHandle> left;
+        for (size_t i = 0; i < coins.size(); i++) left.push_back(coins.handleOf(i));
+        while (!left.empty()) {
+            size_t nearest = 0;
+            float nearestDistance = 0.0f;
+            for (size_t i = 0; i < left.size(); i++) {
+                float d = VectorUtils::Length(VectorUtils::Subtract(coins.get(left[i])->position, stops.back()));
+                if (i == 0 || d < nearestDistance) {
+                    nearest = i;
+                    nearestDistance = d;
+                }
+            }
+            tour.push_back(left[nearest]);
+            stops.push_back(coins.get(left[nearest])->position);
+            left[nearest] = left.back();
+            left.pop_back();
+        }
+
+        // Reversing stops[i..j] swaps edges (i-1, i) and (j, j+1) for (i-1, j) and (i, j+1)
+        auto length = [&stops](size_t a, size_t b) { return VectorUtils::Length(VectorUtils::Subtract(stops[a], stops[b])); };
+        size_t last = stops.size() - 1;
+        bool improved = true;
+        for (int pass = 0; pass < maxPasses && improved; pass++) {
+            improved = false;
+            for (size_t i = 1; i < last; i++) {
+                for (size_t j = i + 1; j <= last; j++) {
+                    float before = length(i - 1, i) + (j < last ? length(j, j + 1) : 0.0f);
+                    float after = length(i - 1, j) + (j < last ? length(i, j + 1) : 0.0f);
+                    if (after + 0.01f < before) {
+                        std::reverse(stops.begin() + i, stops.begin() + j + 1);
+                        std::reverse(tour.begin() + (i - 1), tour.begin() + j);
+                        improved = true;
+                    }
+                }
+            }
+        }
+        next = 0;
+    }
+
+    // BFS from the coin through cells a robber fits in; cells close to the coin always pass,
+    // as Pursuit does for cops
+    void fillGoal(const NavGrid& nav, int cell, uint16_t need) {
+        if (++goalStamp == 0) {
+            std::fill(goalSeen.begin(), goalSeen.end(), 0);
+            goalStamp = 1;
+        }
+        goalCell = cell;
+        queue.clear();
+        goalSeen[cell] = goalStamp;
+        goal[cell] = 0;
+        queue.push_back(cell);
+        for (size_t front = 0; front < queue.size(); front++) {
+            int i = queue[front];
+            int cx = i % nav.width;
+            int cy = i / nav.width;
+            uint16_t step = static_cast<uint16_t>(goal[i] + 1);
+            int around[4] = {cx > 0 ? i - 1 : -1, cx < nav.width - 1 ? i + 1 : -1, cy > 0 ? i - nav.width : -1, cy < nav.height - 1 ? i + nav.width : -1};
+            for (int n : around) {
+                if (n < 0 || goalSeen[n] == goalStamp || nav.blocked[n]) continue;
+                if (nav.clearance[n] < need && step > need) continue;
+                goalSeen[n] = goalStamp;
+                goal[n] = step;
+                queue.push_back(n);
+            }
+        }
+    }
+};
+
+// MctsPlanner class for the hard difficulty: Monte Carlo tree search over where the lead cop
+// (and the level's first cop, when there is one) should head for the next decisionTicks.
+// Rollouts replay the chase on the nav grid: the planned cops take the tree's headings, the
+// robber flees the nearest of them with some noise, and a rollout scores by how soon the robber
+// is caught. Each tick searches for a fixed budget on every core. Searchers come in pairs per
+// tree and spread out with virtual loss; the trees are independent (root parallelism), and their
+// visit counts are summed to decide. Each decision keeps the chosen subtree for the next search.
+class MctsPlanner {
+public:
+    enum : uint8_t {
+        Pursue = 8,     // 0-7 are compass headings; Pursue keeps the cop's own aim
+        ActionCount = 9
+    };
+    static constexpr int maxPlanned = 2;
+    static constexpr int decisionTicks = 10;   // A heading is held this long
+    static constexpr int horizonTicks = 120;
+    static constexpr int searchersPerTree = 2;
+    static constexpr int expandVisits = 2;     // A leaf grows children on its second visit
+    static constexpr int maxNodes = 1 << 17;   // Per tree; a full tree stops growing until the next decision
+    static constexpr float exploration = 0.7f;
+    static constexpr float jitter = 1.2f;      // Radians of noise on the rollout robber's heading
+    static constexpr float shapingRange = 600.0f;
+
+    // The real chase the search starts from
+    struct Snapshot {
+        Vector2 robber;
+        float robberSpeed;
+        float robberRadius;
+        int planned;
+        Vector2 cops[maxPlanned];
+        float copSpeeds[maxPlanned];
+        float copRadii[maxPlanned];
+        uint8_t committed[maxPlanned]; // Headings being held until the next decision
+        int ticksToDecision;
+    };
+
+    int workerCount; // Threads besides the caller's
+    int treeCount;
+
+    MctsPlanner(int threads, uint64_t seed) : workerCount(threads), treeCount((threads + searchersPerTree) / searchersPerTree),
+                                             trees(treeCount), searchers(threads + 1), nav(nullptr), job(), generation(0), busy(0), stopping(false) {
+        for (int a = 0; a < 8; a++) compass[a] = {cosf(a * PI / 4), sinf(a * PI / 4)};
+        for (size_t s = 0; s < searchers.size(); s++) {
+            searchers[s].rng = Random(seed + s * 0x9E3779B97F4A7C15ull);
+            searchers[s].rollouts = 0;
+        }
+        for (Tree& tree : trees) tree.nodes.reserve(maxNodes);
+        scratch.reserve(maxNodes);
+        reset();
+        for (int w = 0; w < workerCount; w++) workers.emplace_back(&MctsPlanner::work, this, w);
+    }
+
+    ~MctsPlanner() {
+        {
+            std::lock_guard<std::mutex> hold(poolLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    MctsPlanner(const MctsPlanner&) = delete;
+    MctsPlanner& operator=(const MctsPlanner&) = delete;
+
+    // Drop every tree: a new level, or a different set of planned cops
+    void reset() {
+        for (Tree& tree : trees) {
+            tree.nodes.clear();
+            tree.nodes.push_back({-1, 0, 0.0f});
+        }
+    }
+
+    // Grow the trees from `snapshot` on every searcher until `budgetMs` is spent. Blocks.
+    void search(const NavGrid& grid, const Snapshot& snapshot, double budgetMs) {
+        nav = &grid;
+        job = snapshot;
+        deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<long long>(budgetMs * 1000.0));
+        {
+            std::lock_guard<std::mutex> hold(poolLock);
+            busy = workerCount;
+            generation++;
+        }
+        wake.notify_all();
+        grow(workerCount);
+        std::unique_lock<std::mutex> hold(poolLock);
+        done.wait(hold, [this] { return busy == 0; });
+    }
+
+    // Pick each planned cop's heading from the summed visits and move every tree's root down to
+    // the pick, so its statistics carry into the next search
+    void commit(uint8_t* out) {
+        std::vector<int> at(treeCount, 0);
+        for (int c = 0; c < job.planned; c++) {
+            int visits[ActionCount] = {};
+            for (int t = 0; t < treeCount; t++) {
+                if (at[t] < 0 || trees[t].nodes[at[t]].firstChild < 0) continue;
+                for (int a = 0; a < ActionCount; a++) visits[a] += trees[t].nodes[trees[t].nodes[at[t]].firstChild + a].visits;
+            }
+            int best = Pursue;
+            for (int a = 0; a < ActionCount; a++) {
+                if (visits[a] > visits[best]) best = a;
+            }
+            out[c] = static_cast<uint8_t>(best);
+            for (int t = 0; t < treeCount; t++) {
+                int first = at[t] < 0 ? -1 : trees[t].nodes[at[t]].firstChild;
+                at[t] = first < 0 ? -1 : first + best;
+            }
+        }
+        for (int t = 0; t < treeCount; t++) reroot(trees[t], at[t]);
+    }
+
+    Vector2 heading(int action) const { return compass[action]; }
+
+    // Rollouts since construction, over every searcher
+    uint64_t rollouts() const {
+        uint64_t total = 0;
+        for (const Searcher& searcher : searchers) total += searcher.rollouts;
+        return total;
+    }
+
+private:
+    struct Node {
+        int firstChild; // ActionCount children in a row, or -1 while a leaf
+        int visits;
+        float value;    // Sum of rollout rewards
+    };
+
+    struct Tree {
+        std::mutex lock;
+        std::vector<Node> nodes; // nodes[0] is the root
+    };
+
+    struct Searcher {
+        Random rng;
+        uint64_t rollouts;
+        std::vector<int> path;
+    };
+
+    std::vector<Tree> trees;
+    std::vector<Searcher> searchers; // One per worker, then the caller's
+    std::vector<Node> scratch;
+    std::vector<std::thread> workers;
+    Vector2 compass[8];
+
+    // The current search, written before the workers are woken
+    const NavGrid* nav;
+    Snapshot job;
+    std::chrono::steady_clock::time_point deadline;
+
+    std::mutex poolLock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation;
+    int busy;
+    bool stopping;
+
+    void work(int worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> hold(poolLock);
+                wake.wait(hold, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            grow(worker);
+            std::lock_guard<std::mutex> hold(poolLock);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+    // Select, roll out and back up until the deadline. Only selection and backup hold the tree.
+    void grow(int index) {
+        Searcher& searcher = searchers[index];
+        Tree& tree = trees[index / searchersPerTree];
+        int depthLimit = job.planned * (horizonTicks / decisionTicks);
+        uint8_t actions[maxPlanned * (horizonTicks / decisionTicks)];
+        while (std::chrono::steady_clock::now() < deadline) {
+            int depth = select(tree, searcher.path, actions, depthLimit);
+            float reward = rollout(actions, depth, searcher.rng);
+            std::lock_guard<std::mutex> hold(tree.lock);
+            for (int node : searcher.path) tree.nodes[node].value += reward;
+            searcher.rollouts++;
+        }
+    }
+
+    // Walk down by UCB1, counting each visit on the way (the virtual loss that sends the other
+    // searcher on this tree elsewhere until the reward comes back). Returns the actions taken.
+    int select(Tree& tree, std::vector<int>& path, uint8_t* actions, int depthLimit) {
+        std::lock_guard<std::mutex> hold(tree.lock);
+        std::vector<Node>& nodes = tree.nodes;
+        path.clear();
+        path.push_back(0);
+        nodes[0].visits++;
+        int node = 0;
+        int depth = 0;
+        while (depth < depthLimit) {
+            if (nodes[node].firstChild < 0) {
+                bool ready = node == 0 || nodes[node].visits >= expandVisits;
+                if (!ready || nodes.size() + ActionCount > static_cast<size_t>(maxNodes)) break;
+                nodes[node].firstChild = static_cast<int>(nodes.size());
+                for (int a = 0; a < ActionCount; a++) nodes.push_back({-1, 0, 0.0f});
+            }
+            int first = nodes[node].firstChild;
+            float logVisits = logf(static_cast<float>(nodes[node].visits));
+            int best = 0;
+            float bestScore = -1.0f;
+            for (int a = 0; a < ActionCount; a++) {
+                const Node& child = nodes[first + a];
+                if (child.visits == 0) {
+                    best = a;
+                    break;
+                }
+                float score = child.value / child.visits + exploration * sqrtf(logVisits / child.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = a;
+                }
+            }
+            node = first + best;
+            actions[depth++] = static_cast<uint8_t>(best);
+            path.push_back(node);
+            if (nodes[node].visits++ == 0) break;
+        }
+        return depth;
+    }
+
+    // Play the chase out: finish the committed headings, follow `actions`, then pursue.
+    // A capture scores 0.5 to 1 by how soon; otherwise up to 0.5 by how close a cop ended.
+    float rollout(const uint8_t* actions, int depth, Random& rng) const {
+        Vector2 robber = job.robber;
+        Vector2 cops[maxPlanned];
+        uint8_t held[maxPlanned];
+        uint16_t robberNeed = need(job.robberRadius);
+        uint16_t copNeed[maxPlanned];
+        for (int c = 0; c < job.planned; c++) {
+            cops[c] = job.cops[c];
+            held[c] = job.committed[c];
+            copNeed[c] = need(job.copRadii[c]);
+        }
+
+        Vector2 wander = {0.0f, 0.0f};
+        int wanderTicks = 0;
+        int left = job.ticksToDecision;
+        int next = 0;
+        float closest = 0.0f;
+        for (int t = 0; t < horizonTicks; t++) {
+            if (left == 0) {
+                for (int c = 0; c < job.planned; c++, next++) held[c] = next < depth ? actions[next] : static_cast<uint8_t>(Pursue);
+                left = decisionTicks;
+            }
+            left--;
+
+            int nearest = 0;
+            float nearestDistance = VectorUtils::Length(VectorUtils::Subtract(cops[0], robber));
+            for (int c = 1; c < job.planned; c++) {
+                float distance = VectorUtils::Length(VectorUtils::Subtract(cops[c], robber));
+                if (distance < nearestDistance) {
+                    nearestDistance = distance;
+                    nearest = c;
+                }
+            }
+            Vector2 away = VectorUtils::Normalize(VectorUtils::Subtract(robber, cops[nearest]));
+            if (wanderTicks > 0) {
+                wanderTicks--;
+                away = wander;
+            } else {
+                float turn = (rng.uniform() - 0.5f) * jitter;
+                away = {away.x * cosf(turn) - away.y * sinf(turn), away.x * sinf(turn) + away.y * cosf(turn)};
+            }
+            Vector2 moved = slide(robber, VectorUtils::Scale(away, job.robberSpeed), robberNeed);
+            if (moved.x == robber.x && moved.y == robber.y) {
+                wander = compass[rng.range(8)];
+                wanderTicks = decisionTicks;
+            }
+            robber = moved;
+
+            closest = shapingRange;
+            for (int c = 0; c < job.planned; c++) {
+                Vector2 direction = held[c] == Pursue ? VectorUtils::Normalize(VectorUtils::Subtract(robber, cops[c])) : compass[held[c]];
+                cops[c] = slide(cops[c], VectorUtils::Scale(direction, job.copSpeeds[c]), copNeed[c]);
+                float distance = VectorUtils::Length(VectorUtils::Subtract(cops[c], robber));
+                if (distance < job.robberRadius + job.copRadii[c]) return 1.0f - 0.5f * t / horizonTicks;
+                if (distance < closest) closest = distance;
+            }
+        }
+        return 0.5f * (1.0f - closest / shapingRange);
+    }
+
+    // Cells of clearance a circle needs, as Pursuit counts them
+    uint16_t need(float radius) const {
+        return static_cast<uint16_t>(1 + ceilf(radius / nav->cellSize));
+    }
+
+    // Take the step, or failing that one axis of it. A cell too tight for the circle is still
+    // allowed when it is no tighter than the one it is leaving, so a robber hugging a wall can
+    // move off it.
+    Vector2 slide(Vector2 from, Vector2 step, uint16_t required) const {
+        Vector2 tries[3] = {VectorUtils::Add(from, step), {from.x + step.x, from.y}, {from.x, from.y + step.y}};
+        uint16_t current = nav->clearance[nav->index(from)];
+        uint16_t enough = current < required ? current : required;
+        for (const Vector2& to : tries) {
+            if (to.x < 0.0f || to.y < 0.0f || to.x >= nav->width * nav->cellSize || to.y >= nav->height * nav->cellSize) continue;
+            if (nav->clearance[nav->index(to)] >= enough && nav->clearance[nav->index(to)] > 0) return to;
+        }
+        return from;
+    }
+
+    // Copy the subtree under `root` (breadth first, so children stay in a row) to the front
+    void reroot(Tree& tree, int root) {
+        scratch.clear();
+        scratch.push_back(root < 0 ? Node{-1, 0, 0.0f} : tree.nodes[root]);
+        for (size_t head = 0; head < scratch.size(); head++) {
+            int first = scratch[head].firstChild;
+            if (first < 0) continue;
+            scratch[head].firstChild = static_cast<int>(scratch.size());
+            for (int a = 0; a < ActionCount; a++) scratch.push_back(tree.nodes[first + a]);
+        }
+        tree.nodes.swap(scratch);
+    }
+};
+
+// GridChase class for the chase as a turn-based game on a coarse grid: the robber steps to a
+// neighbouring cell or stays, then each cop does, and a cop landing on the robber's cell (or the
+// robber on a cop's) ends it. Coins are picked up by stepping on their cell; taking the last one
+// wins for the robber. Coarse cells are at least a cop wide and few enough that every
+// cell-to-cell distance fits in a table. Positions carry their own Zobrist key.
+class GridChase {
+public:
+    static constexpr int maxCells = 2048;
+    static constexpr int maxCops = 4;
+    static constexpr int maxCoins = 32;
+    static constexpr int maxMoves = 5;
+    static constexpr uint8_t unreachable = 255;
+    static constexpr int winScore = 30000;     // Minus the plies it took
+    static constexpr int coinScore = 100;
+    static constexpr int copDistanceCap = 8;   // Cops further than this do not worry the robber
+    enum Direction { Stay, Up, Right, Down, Left, directionCount };
+
+    struct Position {
+        uint64_t key;
+        int16_t robber;
+        int16_t cops[maxCops];
+        uint32_t coins; // Bit i set while coin i is on the map
+        uint8_t toMove; // 0 for the robber, 1 + i for cop i
+    };
+
+    float cellSize;
+    int width;
+    int height;
+    int copCount;
+    int coinCount;
+    int coinsNeeded; // Taken coins that win
+
+    GridChase() : cellSize(1.0f), width(0), height(0), copCount(0), coinCount(0), coinsNeeded(0) {}
+
+    // Coarsen `nav` for circles of `radius` into at most `cellLimit` cells. A cell is open if a
+    // circle fits at its centre, and two neighbours are joined if nothing blocks the line between
+    // their centres.
+    void build(const NavGrid& nav, float radius, int cellLimit = maxCells) {
+        int factor = std::max(1, static_cast<int>(ceilf(2.0f * radius / nav.cellSize)));
+        while (((nav.width + factor - 1) / factor) * ((nav.height + factor - 1) / factor) > cellLimit) factor++;
+        cellSize = factor * nav.cellSize;
+        width = (nav.width + factor - 1) / factor;
+        height = (nav.height + factor - 1) / factor;
+        int cells = width * height;
+        uint16_t need = static_cast<uint16_t>(1 + ceilf(radius / nav.cellSize));
+
+        open.assign(cells, 0);
+        for (int i = 0; i < cells; i++) {
+            Vector2 centre = center(i);
+            open[i] = centre.x < nav.width * nav.cellSize && centre.y < nav.height * nav.cellSize && nav.clearance[nav.index(centre)] >= need;
+        }
+        links.assign(cells, 0);
+        for (int i = 0; i < cells; i++) {
+            if (!open[i]) continue;
+            if (i % width < width - 1 && open[i + 1] && clearLine(nav, center(i), center(i + 1))) {
+                links[i] |= East;
+                links[i + 1] |= West;
+            }
+            if (i / width < height - 1 && open[i + width] && clearLine(nav, center(i), center(i + width))) {
+                links[i] |= South;
+                links[i + width] |= North;
+            }
+        }
+
+        // Breadth first from every open cell
+        distance.assign(static_cast<size_t>(cells) * cells, static_cast<uint8_t>(unreachable));
+        std::vector<int> queue(cells);
+        for (int from = 0; from < cells; from++) {
+            if (!open[from]) continue;
+            uint8_t* row = &distance[static_cast<size_t>(from) * cells];
+            row[from] = 0;
+            queue[0] = from;
+            for (int head = 0, tail = 1; head < tail; head++) {
+                int at = queue[head];
+                if (row[at] == unreachable - 1) continue;
+                int16_t next[maxMoves];
+                int count = neighbours(static_cast<int16_t>(at), next);
+                for (int n = 1; n < count; n++) {
+                    if (row[next[n]] != unreachable) continue;
+                    row[next[n]] = static_cast<uint8_t>(row[at] + 1);
+                    queue[tail++] = next[n];
+                }
+            }
+        }
+
+        Random rng(0x5EED);
+        auto fill = [&rng](std::vector<uint64_t>& keys, size_t count) {
+            keys.resize(count);
+            for (uint64_t& key : keys) key = (static_cast<uint64_t>(rng.next()) << 32) | rng.next();
+        };
+        fill(robberKeys, cells);
+        fill(copKeys, static_cast<size_t>(cells) * maxCops);
+        fill(coinKeys, maxCoins);
+        fill(sideKeys, maxCops + 1);
+    }
+
+    // The nearest open cell to `p`: the one it is in when that is open. -1 when no cell is open.
+    int16_t cellAt(Vector2 p) const {
+        int x = static_cast<int>(p.x / cellSize);
+        int y = static_cast<int>(p.y / cellSize);
+        if (p.x >= 0.0f && p.y >= 0.0f && x < width && y < height && open[y * width + x]) return static_cast<int16_t>(y * width + x);
+        int best = -1;
+        float bestDistance = 0.0f;
+        for (int i = 0; i < width * height; i++) {
+            if (!open[i]) continue;
+            float d = VectorUtils::Length(VectorUtils::Subtract(center(i), p));
+            if (best < 0 || d < bestDistance) {
+                best = i;
+                bestDistance = d;
+            }
+        }
+        return static_cast<int16_t>(best);
+    }
+
+    // Robber to move. Cops past maxCops and coins past maxCoins are left out. False when the grid
+    // has no open cell to put them on.
+    bool start(Vector2 robber, const std::vector<Vector2>& cops, const std::vector<Vector2>& coins, int needed, Position& p) {
+        // cellAt only fails when no cell is open, so checking the robber's covers the cops and coins
+        p.robber = cellAt(robber);
+        if (p.robber < 0) return false;
+        copCount = std::min(static_cast<int>(cops.size()), static_cast<int>(maxCops));
+        for (int c = 0; c < maxCops; c++) p.cops[c] = c < copCount ? cellAt(cops[c]) : static_cast<int16_t>(-1);
+        coinCount = std::min(static_cast<int>(coins.size()), static_cast<int>(maxCoins));
+        coinsNeeded = std::min(needed, coinCount);
+        coinsAt.assign(width * height, 0);
+        for (int i = 0; i < coinCount; i++) {
+            coinCells[i] = cellAt(coins[i]);
+            coinsAt[coinCells[i]] |= 1u << i;
+        }
+        p.coins = coinCount == maxCoins ? 0xFFFFFFFFu : (1u << coinCount) - 1;
+        p.toMove = 0;
+        p.key = robberKeys[p.robber] ^ sideKeys[0];
+        for (int c = 0; c < copCount; c++) p.key ^= copKeys[p.cops[c] * maxCops + c];
+        for (int i = 0; i < coinCount; i++) p.key ^= coinKeys[i];
+        return true;
+    }
+
+    // Where the side to move can go, staying put first
+    int moves(const Position& p, int16_t* out) const {
+        return neighbours(p.toMove == 0 ? p.robber : p.cops[p.toMove - 1], out);
+    }
+
+    Position play(const Position& p, int16_t to) const {
+        Position next = p;
+        if (p.toMove == 0) {
+            next.robber = to;
+            next.key ^= robberKeys[p.robber] ^ robberKeys[to];
+            uint32_t taken = next.coins & coinsAt[to];
+            next.coins &= ~taken;
+            for (int i = 0; taken; i++, taken >>= 1) {
+                if (taken & 1) next.key ^= coinKeys[i];
+            }
+        } else {
+            int c = p.toMove - 1;
+            next.cops[c] = to;
+            next.key ^= copKeys[p.cops[c] * maxCops + c] ^ copKeys[to * maxCops + c];
+        }
+        next.toMove = static_cast<uint8_t>(p.toMove == copCount ? 0 : p.toMove + 1);
+        next.key ^= sideKeys[p.toMove] ^ sideKeys[next.toMove];
+        return next;
+    }
+
+    // True once someone has won; `score` is then from the robber's side, before ply adjustment
+    bool over(const Position& p, int& score) const {
+        for (int c = 0; c < copCount; c++) {
+            if (p.cops[c] == p.robber) {
+                score = -winScore;
+                return true;
+            }
+        }
+        if (coinCount > 0 && coinCount - remaining(p.coins) >= coinsNeeded) {
+            score = winScore;
+            return true;
+        }
+        return false;
+    }
+
+    // From the robber's side: coins taken, closeness to the next one, room from the cops
+    int evaluate(const Position& p) const {
+        int score = 0;
+        int nearestCoin = p.coins ? unreachable : 0;
+        for (int i = 0; i < coinCount; i++) {
+            if (p.coins & (1u << i)) nearestCoin = std::min(nearestCoin, static_cast<int>(steps(p.robber, coinCells[i])));
+            else score += coinScore;
+        }
+        int nearestCop = copDistanceCap;
+        for (int c = 0; c < copCount; c++) nearestCop = std::min(nearestCop, static_cast<int>(steps(p.cops[c], p.robber)));
+        return score - nearestCoin + 4 * nearestCop;
+    }
+
+    uint8_t steps(int16_t from, int16_t to) const {
+        return distance[static_cast<size_t>(from) * width * height + to];
+    }
+
+    bool isOpen(int cell) const {
+        return open[cell] != 0;
+    }
+
+    // The cell one step from `cell` in `direction` (Stay, Up, Right, Down, Left), or -1 where
+    // the two are not joined
+    int16_t toward(int16_t cell, int direction) const {
+        switch (direction) {
+        case Up: return links[cell] & North ? static_cast<int16_t>(cell - width) : static_cast<int16_t>(-1);
+        case Right: return links[cell] & East ? static_cast<int16_t>(cell + 1) : static_cast<int16_t>(-1);
+        case Down: return links[cell] & South ? static_cast<int16_t>(cell + width) : static_cast<int16_t>(-1);
+        case Left: return links[cell] & West ? static_cast<int16_t>(cell - 1) : static_cast<int16_t>(-1);
+        default: return cell;
+        }
+    }
+
+    // FNV-1a over the size and every cell's links: equal for the same coarse map
+    uint64_t layoutKey() const {
+        uint64_t key = 0xCBF29CE484222325ull;
+        auto mix = [&key](uint32_t value) {
+            key ^= value;
+            key *= 0x100000001B3ull;
+        };
+        mix(static_cast<uint32_t>(width));
+        mix(static_cast<uint32_t>(height));
+        for (size_t i = 0; i < links.size(); i++) mix(links[i] | (open[i] << 4));
+        return key;
+    }
+
+    Vector2 center(int cell) const {
+        return {(cell % width + 0.5f) * cellSize, (cell / width + 0.5f) * cellSize};
+    }
+
+private:
+    enum : uint8_t { North = 1, East = 2, South = 4, West = 8 };
+
+    std::vector<uint8_t> open;
+    std::vector<uint8_t> links;    // Direction bits to joined neighbours
+    std::vector<uint8_t> distance; // Steps between every pair of cells, row per source
+    std::vector<uint32_t> coinsAt; // Coin bits per cell
+    int16_t coinCells[maxCoins];
+    std::vector<uint64_t> robberKeys;
+    std::vector<uint64_t> copKeys; // cell * maxCops + cop
+    std::vector<uint64_t> coinKeys;
+    std::vector<uint64_t> sideKeys;
+
+    static int remaining(uint32_t coins) {
+        int count = 0;
+        for (; coins; coins &= coins - 1) count++;
+        return count;
+    }
+
+    int neighbours(int16_t cell, int16_t* out) const {
+        int count = 0;
+        out[count++] = cell;
+        if (links[cell] & North) out[count++] = static_cast<int16_t>(cell - width);
+        if (links[cell] & East) out[count++] = static_cast<int16_t>(cell + 1);
+        if (links[cell] & South) out[count++] = static_cast<int16_t>(cell + width);
+        if (links[cell] & West) out[count++] = static_cast<int16_t>(cell - 1);
+        return count;
+    }
+
+    static bool clearLine(const NavGrid& nav, Vector2 a, Vector2 b) {
+        Vector2 delta = VectorUtils::Subtract(b, a);
+        int samples = std::max(1, static_cast<int>(ceilf(VectorUtils::Length(delta) / nav.cellSize)));
+        for (int s = 1; s < samples; s++) {
+            if (nav.isBlocked(VectorUtils::Add(a, VectorUtils::Scale(delta, static_cast<float>(s) / samples)))) return false;
+        }
+        return true;
+    }
+};
+
+// GridSearch class for iterative-deepening alpha-beta over GridChase positions, the robber
+// maximizing and the cops minimizing. Threads share one transposition table (lazy SMP): each
+// runs its own deepening, helpers a ply ahead or with their moves rotated, and the table
+// spreads what any of them learns. Entries are two relaxed atomic words, the first being the
+// key xor the second, so a torn write reads back as a miss instead of a wrong hit.
+class GridSearch {
+public:
+    static constexpr int maxDepth = 64;
+    static constexpr int clockMask = 1023; // Check the deadline every 1024 nodes
+
+    struct Result {
+        int score;      // From the robber's side
+        int16_t move;   // Best cell for the side to move
+        int depth;      // Deepest iteration the main thread finished
+        uint64_t nodes; // Over every thread
+    };
+
+    explicit GridSearch(int tableBits = 20) : table(static_cast<size_t>(1) << tableBits), mask((static_cast<uint64_t>(1) << tableBits) - 1) {}
+
+    Result run(const GridChase& chase, const GridChase::Position& root, double budgetMs, int threads) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<long long>(budgetMs * 1000.0));
+        stop.store(false, std::memory_order_relaxed);
+        std::vector<Worker> workers(std::max(1, threads));
+        for (size_t w = 0; w < workers.size(); w++) {
+            workers[w].id = static_cast<int>(w);
+            workers[w].nodes = 0;
+        }
+
+        std::vector<std::thread> helpers;
+        for (size_t w = 1; w < workers.size(); w++) helpers.emplace_back(&GridSearch::deepen, this, std::cref(chase), std::cref(root), std::ref(workers[w]));
+        Result result = deepen(chase, root, workers[0]);
+        stop.store(true, std::memory_order_relaxed);
+        for (std::thread& helper : helpers) helper.join();
+        result.nodes = 0;
+        for (const Worker& worker : workers) result.nodes += worker.nodes;
+        return result;
+    }
+
+    void clear() {
+        for (Entry& entry : table) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    enum : uint64_t { Exact = 1, Lower = 2, Upper = 3 };
+    static constexpr int infinity = GridChase::winScore + 1;
+    static constexpr int decisive = GridChase::winScore - 1000; // Past this a score is a win or loss
+
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data; // score + 32768 | depth << 16 | bound << 24 | move cell + 1 << 32
+    };
+
+    struct Worker {
+        int id;
+        uint64_t nodes;
+    };
+
+    std::vector<Entry> table;
+    uint64_t mask;
+    std::atomic<bool> stop;
+    std::chrono::steady_clock::time_point deadline;
+
+    // Iterative deepening until the deadline; returns the last iteration that finished
+    Result deepen(const GridChase& chase, const GridChase::Position& root, Worker& worker) {
+        Result result = {0, -1, 0, 0};
+        for (int depth = 1 + worker.id % 2; depth <= maxDepth; depth++) {
+            int16_t move = -1;
+            int score = search(chase, root, depth, -infinity, infinity, 0, worker, &move);
+            if (stop.load(std::memory_order_relaxed)) break;
+            result = {score, move, depth, 0};
+            if (score >= decisive || score <= -decisive) break;
+        }
+        if (worker.id == 0) stop.store(true, std::memory_order_relaxed);
+        return result;
+    }
+
+    int search(const GridChase& chase, const GridChase::Position& p, int depth, int alpha, int beta, int ply, Worker& worker, int16_t* bestOut) {
+        if ((++worker.nodes & clockMask) == 0 && std::chrono::steady_clock::now() >= deadline) stop.store(true, std::memory_order_relaxed);
+        if (stop.load(std::memory_order_relaxed)) return 0;
+        int terminal;
+        if (chase.over(p, terminal)) return terminal > 0 ? terminal - ply : terminal + ply;
+        if (depth == 0) return chase.evaluate(p);
+
+        int16_t hashMove = -1;
+        int stored, storedDepth;
+        uint64_t bound;
+        if (probe(p.key, stored, storedDepth, bound, hashMove) && ply > 0 && storedDepth >= depth) {
+            stored = fromTable(stored, ply);
+            if (bound == Exact || (bound == Lower && stored >= beta) || (bound == Upper && stored <= alpha)) return stored;
+        }
+
+        int16_t moves[GridChase::maxMoves];
+        int count = chase.moves(p, moves);
+        order(moves, count, hashMove, worker.id);
+
+        bool robberToMove = p.toMove == 0;
+        int alphaIn = alpha, betaIn = beta;
+        int best = robberToMove ? -infinity : infinity;
+        int16_t bestMove = moves[0];
+        for (int m = 0; m < count; m++) {
+            int score = search(chase, chase.play(p, moves[m]), depth - 1, alpha, beta, ply + 1, worker, nullptr);
+            if (stop.load(std::memory_order_relaxed)) return 0;
+            if (robberToMove ? score > best : score < best) {
+                best = score;
+                bestMove = moves[m];
+            }
+            if (robberToMove) alpha = std::max(alpha, best);
+            else beta = std::min(beta, best);
+            if (alpha >= beta) break;
+        }
+
+        uint64_t kind = best <= alphaIn ? Upper : best >= betaIn ? Lower : Exact;
+        save(p.key, toTable(best, ply), depth, kind, bestMove);
+        if (bestOut) *bestOut = bestMove;
+        return best;
+    }
+
+    // Hash move first; helpers rotate the rest so threads part ways early
+    static void order(int16_t* moves, int count, int16_t hashMove, int id) {
+        if (id > 0 && count > 1) std::rotate(moves, moves + id % count, moves + count);
+        for (int m = 0; m < count; m++) {
+            if (moves[m] == hashMove) {
+                std::rotate(moves, moves + m, moves + m + 1);
+                break;
+            }
+        }
+    }
+
+    // Wins and losses are stored by distance from the entry, not the root
+    static int toTable(int score, int ply) {
+        return score >= decisive ? score + ply : score <= -decisive ? score - ply : score;
+    }
+
+    static int fromTable(int score, int ply) {
+        return score >= decisive ? score - ply : score <= -decisive ? score + ply : score;
+    }
+
+    bool probe(uint64_t key, int& score, int& depth, uint64_t& bound, int16_t& move) const {
+        const Entry& entry = table[key & mask];
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+        score = static_cast<int>(data & 0xFFFF) - 32768;
+        depth = static_cast<int>((data >> 16) & 0xFF);
+        bound = (data >> 24) & 0x3;
+        move = static_cast<int16_t>(static_cast<int>((data >> 32) & 0xFFFF) - 1);
+        return true;
+    }
+
+    // Always replace: the deepening rewrites what matters each iteration
+    void save(uint64_t key, int score, int depth, uint64_t bound, int16_t move) {
+        uint64_t data = static_cast<uint64_t>(score + 32768) | static_cast<uint64_t>(depth) << 16 | bound << 24 |
+                        static_cast<uint64_t>(move + 1) << 32;
+        Entry& entry = table[key & mask];
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+};
+
+// CopTable class for a tabular cop policy on GridChase cells, learned by QTrainer: for each
+// level, the step a cop takes from its coarse cell given the robber's cell and its role, the
+// chaser (the cop nearest the robber) or a cutter (any other). Steps are 4-bit GridChase
+// directions, or `unknown` where the robber cannot be reached, packed two to a byte. A file is
+// a uint32 header {magic, version, tables, 0} and per table {level, cells, layout key low,
+// high} followed by its packed steps. A table only applies to a map whose coarse grid still
+// has the layout key it was trained on.
+class CopTable {
+public:
+    enum : uint32_t { Magic = 0x54515243, Version = 1 }; // "CRQT"
+    enum Role { Chaser, Cutter, roleCount };
+    static constexpr int maxCells = 512;   // Coarse cell cap for tabled levels: 256 KB of steps each
+    static constexpr uint8_t unknown = 15;
+
+    struct Table {
+        int level;
+        int cells;
+        uint64_t layout;
+        std::vector<uint8_t> steps; // (role * cells + cop cell) * cells + robber cell
+    };
+
+    std::vector<Table> tables;
+
+    static size_t stepCount(int cells) {
+        return static_cast<size_t>(roleCount) * cells * cells;
+    }
+
+    static Table blank(int level, const GridChase& chase) {
+        Table table;
+        table.level = level;
+        table.cells = chase.width * chase.height;
+        table.layout = chase.layoutKey();
+        table.steps.assign((stepCount(table.cells) + 1) / 2, 0xFF);
+        return table;
+    }
+
+    static uint8_t get(const Table& table, int role, int cop, int robber) {
+        size_t i = (static_cast<size_t>(role) * table.cells + cop) * table.cells + robber;
+        return (table.steps[i >> 1] >> ((i & 1) * 4)) & 15;
+    }
+
+    static void set(Table& table, int role, int cop, int robber, uint8_t step) {
+        size_t i = (static_cast<size_t>(role) * table.cells + cop) * table.cells + robber;
+        int shift = static_cast<int>(i & 1) * 4;
+        table.steps[i >> 1] = static_cast<uint8_t>((table.steps[i >> 1] & ~(15 << shift)) | (step << shift));
+    }
+
+    // The table for `level` if it was trained on this layout
+    const Table* find(int level, uint64_t layout) const {
+        for (const Table& table : tables) {
+            if (table.level == level && table.layout == layout) return &table;
+        }
+        return nullptr;
+    }
+
+    bool save(const char* path) const {
+        FILE* out = fopen(path, "wb");
+        if (!out) return false;
+        uint32_t header[4] = {Magic, Version, static_cast<uint32_t>(tables.size()), 0};
+        bool ok = fwrite(header, sizeof(header), 1, out) == 1;
+        for (const Table& table : tables) {
+            uint32_t shape[4] = {static_cast<uint32_t>(table.level), static_cast<uint32_t>(table.cells), static_cast<uint32_t>(table.layout), static_cast<uint32_t>(table.layout >> 32)};
+            ok = ok && fwrite(shape, sizeof(shape), 1, out) == 1 && fwrite(table.steps.data(), 1, table.steps.size(), out) == table.steps.size();
+        }
+        fclose(out);
+        return ok;
+    }
+
+    bool load(const char* path) {
+        FILE* in = fopen(path, "rb");
+        if (!in) return false;
+        std::vector<Table> loaded;
+        uint32_t header[4];
+        bool ok = fread(header, sizeof(header), 1, in) == 1 && header[0] == Magic && header[1] == Version;
+        for (uint32_t t = 0; ok && t < header[2]; t++) {
+            uint32_t shape[4];
+            ok = fread(shape, sizeof(shape), 1, in) == 1 && shape[1] >= 1 && shape[1] <= static_cast<uint32_t>(maxCells);
+            if (!ok) break;
+            Table table;
+            table.level = static_cast<int>(shape[0]);
+            table.cells = static_cast<int>(shape[1]);
+            table.layout = shape[2] | (static_cast<uint64_t>(shape[3]) << 32);
+            table.steps.resize((stepCount(table.cells) + 1) / 2);
+            ok = fread(table.steps.data(), 1, table.steps.size(), in) == table.steps.size();
+            loaded.push_back(std::move(table));
+        }
+        ok = ok && fgetc(in) == EOF;
+        fclose(in);
+        if (ok) tables.swap(loaded);
+        return ok;
+    }
+};
+
+// QTrainer class for learning a CopTable by self-play on GridChase. The cops share a Q-table
+// over (role, own cell, robber cell); the robber learns one over (own cell, a cop's cell) and
+// judges a move by the cop it leaves worst off. Both learn by one-step Q-learning with a reward
+// only on a capture, starting from what shortest paths are worth, so training refines a plain
+// chase and flight rather than discovering them. Each thread plays a batch of envs against a
+// private copy of the tables; the copies are averaged between rounds, so no table is written
+// by two threads at once.
+class QTrainer {
+public:
+    static constexpr int envsPerThread = 256;
+    static constexpr int roundSteps = 2048;      // Steps per env between averages
+    static constexpr float learningRate = 0.1f;
+    static constexpr float discount = 0.95f;
+    // Per step a cop takes toward the robber. Against a robber that never blunders one cop
+    // cannot force a capture, every move is worth the same, and a cop that waits stalls the game.
+    static constexpr float closingReward = 0.05f;
+    // Chance of a random move, for both sides and all through training: cooling it lets the
+    // robber settle on a few lines that the cops' table then overfits to
+    static constexpr float exploration = 0.2f;
+    static constexpr int actions = GridChase::directionCount;
+
+    struct Report {
+        uint64_t steps;
+        uint64_t episodes;
+        uint64_t captures;
+    };
+
+    QTrainer() : chase(nullptr), cells(0), copCount(1), horizon(0) {}
+
+    // About `steps` env steps with `cops` cops (as many as the level has, up to GridChase::maxCops)
+    // on `threads` threads, written to `table` as the cops' greedy steps
+    Report train(const GridChase& grid, int cops, uint64_t steps, int threads, uint64_t seed, CopTable::Table& table) {
+        chase = &grid;
+        copCount = std::max(1, std::min(cops, static_cast<int>(GridChase::maxCops)));
+        cells = grid.width * grid.height;
+        horizon = 2 * (grid.width + grid.height);
+        openCells.clear();
+        for (int i = 0; i < cells; i++) {
+            if (grid.isOpen(i)) openCells.push_back(static_cast<int16_t>(i));
+        }
+        Report report = {0, 0, 0};
+        if (openCells.size() < 2) return report;
+
+        size_t pairs = static_cast<size_t>(cells) * cells;
+        copQ.assign(CopTable::roleCount * pairs * actions, 0.0f);
+        robberQ.assign(pairs * actions, 0.0f);
+        std::vector<float> worth(GridChase::unreachable + 1, 0.0f);
+        for (int d = 0; d < GridChase::unreachable; d++) worth[d] = powf(discount, static_cast<float>(d));
+        for (int16_t self : openCells) {
+            for (int16_t other : openCells) {
+                for (int a = 0; a < actions; a++) {
+                    int16_t to = grid.toward(self, a);
+                    if (to < 0) continue;
+                    size_t i = (static_cast<size_t>(self) * cells + other) * actions + a;
+                    for (int role = 0; role < CopTable::roleCount; role++) copQ[role * pairs * actions + i] = worth[grid.steps(to, other)];
+                    robberQ[i] = -worth[grid.steps(other, to)];
+                }
+            }
+        }
+
+        threads = std::max(1, threads);
+        std::vector<Worker> workers(threads);
+        for (int t = 0; t < threads; t++) {
+            workers[t].rng = Random(seed + 0x9E37u * (t + 1));
+            workers[t].envs.resize(envsPerThread);
+            for (Env& env : workers[t].envs) restart(env, workers[t].rng);
+        }
+
+        uint64_t perRound = static_cast<uint64_t>(threads) * envsPerThread * roundSteps;
+        int rounds = static_cast<int>(std::max<uint64_t>(1, (steps + perRound - 1) / perRound));
+        for (int round = 0; round < rounds; round++) {
+            std::vector<std::thread> helpers;
+            for (int t = 1; t < threads; t++) helpers.emplace_back(&QTrainer::play, this, std::ref(workers[t]));
+            play(workers[0]);
+            for (std::thread& helper : helpers) helper.join();
+
+            // Everyone starts the next round from the mean
+            average(copQ, workers, &Worker::copQ);
+            average(robberQ, workers, &Worker::robberQ);
+        }
+
+        for (const Worker& worker : workers) {
+            report.episodes += worker.episodes;
+            report.captures += worker.captures;
+        }
+        report.steps = perRound * rounds;
+        for (int role = 0; role < CopTable::roleCount; role++) {
+            for (int16_t cop : openCells) {
+                for (int16_t robber : openCells) {
+                    if (grid.steps(cop, robber) == GridChase::unreachable) continue;
+                    CopTable::set(table, role, cop, robber, static_cast<uint8_t>(greedy(copRow(copQ.data(), role, cop, robber), cop)));
+                }
+            }
+        }
+        return report;
+    }
+
+private:
+    struct Env {
+        int16_t robber;
+        int16_t cops[GridChase::maxCops];
+        int age;
+        bool waiting;                // The cops' last moves are still to be scored
+        size_t moved[GridChase::maxCops]; // Their Q entries, in the worker's copQ
+        float closed[GridChase::maxCops]; // And the closing reward they earned
+    };
+
+    struct Worker {
+        Random rng;
+        std::vector<Env> envs;
+        std::vector<float> copQ;
+        std::vector<float> robberQ;
+        uint64_t episodes;
+        uint64_t captures;
+
+        Worker() : episodes(0), captures(0) {}
+    };
+
+    const GridChase* chase;
+    int cells;
+    int copCount;
+    int horizon;                   // Steps before an env starts over without a capture
+    std::vector<int16_t> openCells;
+    std::vector<float> copQ;       // ((role * cells + cop cell) * cells + robber cell) * actions + action
+    std::vector<float> robberQ;    // (robber cell * cells + nearest cop cell) * actions + action
+
+    float* copRow(float* q, int role, int16_t cop, int16_t robber) const {
+        return q + ((static_cast<size_t>(role) * cells + cop) * cells + robber) * actions;
+    }
+
+    float* robberRow(float* q, int16_t robber, int16_t cop) const {
+        return q + (static_cast<size_t>(robber) * cells + cop) * actions;
+    }
+
+    static void average(std::vector<float>& into, const std::vector<Worker>& workers, std::vector<float> Worker::*copy) {
+        float share = 1.0f / workers.size();
+        for (size_t i = 0; i < into.size(); i++) {
+            float sum = 0.0f;
+            for (const Worker& worker : workers) sum += (worker.*copy)[i];
+            into[i] = sum * share;
+        }
+    }
+
+    // Everyone on a random open cell the robber's can reach, none on top of the robber
+    void restart(Env& env, Random& rng) const {
+        env.robber = openCells[rng.range(static_cast<int>(openCells.size()))];
+        for (int c = 0; c < copCount; c++) {
+            int16_t cell = env.robber;
+            for (int tries = 0; tries < 32 && (cell == env.robber || chase->steps(cell, env.robber) == GridChase::unreachable); tries++) {
+                cell = openCells[rng.range(static_cast<int>(openCells.size()))];
+            }
+            env.cops[c] = cell;
+        }
+        env.age = 0;
+        env.waiting = false;
+    }
+
+    // The best legal action in row `q`, ties to the first
+    int greedy(const float* q, int16_t cell) const {
+        int best = GridChase::Stay;
+        for (int a = 1; a < actions; a++) {
+            if (q[a] > q[best] && chase->toward(cell, a) >= 0) best = a;
+        }
+        return best;
+    }
+
+    // Greedy, or now and then a random legal move. A robber exploring never walks into a cop
+    // (`env` given): cops would learn to wait for the blunder instead of closing in.
+    int choose(const float* q, int16_t cell, Random& rng, const Env* env = nullptr) const {
+        if (rng.uniform() >= exploration) return greedy(q, cell);
+        int options[actions];
+        int count = 0;
+        for (int a = 0; a < actions; a++) {
+            int16_t to = chase->toward(cell, a);
+            bool taken = false;
+            for (int c = 0; env && c < copCount; c++) taken = taken || env->cops[c] == to;
+            if (to >= 0 && !taken) options[count++] = a;
+        }
+        return count > 0 ? options[rng.range(count)] : greedy(q, cell);
+    }
+
+    // Index of the cop fewest steps from the robber, the chaser
+    int nearestCop(const Env& env) const {
+        int nearest = 0;
+        for (int c = 1; c < copCount; c++) {
+            if (chase->steps(env.cops[c], env.robber) < chase->steps(env.cops[nearest], env.robber)) nearest = c;
+        }
+        return nearest;
+    }
+
+    // The robber's worth of each action against the worst of the cops, each judged alone
+    void threat(float* rq, const Env& env, float* worst) const {
+        const float* first = robberRow(rq, env.robber, env.cops[0]);
+        for (int a = 0; a < actions; a++) worst[a] = first[a];
+        for (int c = 1; c < copCount; c++) {
+            const float* row = robberRow(rq, env.robber, env.cops[c]);
+            for (int a = 0; a < actions; a++) worst[a] = std::min(worst[a], row[a]);
+        }
+    }
+
+    // Turns as in GridChase: the robber steps, then the cops see where it went and step. A cop's
+    // move is scored once the robber has answered it.
+    void play(Worker& worker) {
+        worker.copQ = copQ;
+        worker.robberQ = robberQ;
+        float* cq = worker.copQ.data();
+        float* rq = worker.robberQ.data();
+        for (Env& env : worker.envs) env.waiting = false; // Entries from the last round's copy
+
+        for (int s = 0; s < roundSteps; s++) {
+            for (Env& env : worker.envs) {
+                float fleeing[actions];
+                threat(rq, env, fleeing);
+                int robberAction = choose(fleeing, env.robber, worker.rng, &env);
+                Env next = env;
+                next.robber = chase->toward(env.robber, robberAction);
+                bool caught = false;
+                for (int c = 0; c < copCount; c++) caught = caught || next.cops[c] == next.robber;
+
+                // Walking into a cop ends it; otherwise the cops move against the robber's new cell
+                int chaser = nearestCop(next);
+                float* rows[GridChase::maxCops];
+                for (int c = 0; c < copCount; c++) rows[c] = copRow(cq, c == chaser ? CopTable::Chaser : CopTable::Cutter, next.cops[c], next.robber);
+                if (env.waiting) {
+                    for (int c = 0; c < copCount; c++) {
+                        float target = caught ? 1.0f : env.closed[c] + discount * rows[c][greedy(rows[c], next.cops[c])];
+                        cq[env.moved[c]] += learningRate * (target - cq[env.moved[c]]);
+                    }
+                }
+                if (!caught) {
+                    for (int c = 0; c < copCount; c++) {
+                        int action = choose(rows[c], next.cops[c], worker.rng);
+                        next.moved[c] = static_cast<size_t>(rows[c] - cq) + action;
+                        int16_t from = next.cops[c];
+                        next.cops[c] = chase->toward(from, action);
+                        next.closed[c] = closingReward * (chase->steps(from, next.robber) - chase->steps(next.cops[c], next.robber));
+                        caught = caught || next.cops[c] == next.robber;
+                    }
+                    next.waiting = !caught;
+                    if (caught) {
+                        for (int c = 0; c < copCount; c++) cq[next.moved[c]] += learningRate * (1.0f - cq[next.moved[c]]);
+                    }
+                }
+
+                float after[actions];
+                threat(rq, next, after);
+                float target = caught ? -1.0f : discount * after[greedy(after, next.robber)];
+                for (int c = 0; c < copCount; c++) {
+                    float* row = robberRow(rq, env.robber, env.cops[c]);
+                    row[robberAction] += learningRate * (target - row[robberAction]);
+                }
+
+                if (caught || ++next.age >= horizon) {
+                    worker.episodes++;
+                    if (caught) worker.captures++;
+                    restart(next, worker.rng);
+                }
+                env = next;
+            }
+        }
+    }
+};
+
+// MappedFile class mapping a file read-only into memory
+class MappedFile {
+public:
+    const uint8_t* data;
+    size_t size;
+
+    MappedFile() : data(nullptr), size(0) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const char* path) {
+        close();
+#if defined(_WIN32)
+        FILE* in = fopen(path, "rb");
+        if (!in) return false;
+        fseek(in, 0, SEEK_END);
+        long length = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        uint8_t* buffer = static_cast<uint8_t*>(malloc(length > 0 ? length : 1));
+        bool ok = length > 0 && fread(buffer, 1, length, in) == static_cast<size_t>(length);
+        fclose(in);
+        if (!ok) {
+            free(buffer);
+            return false;
+        }
+        data = buffer;
+        size = static_cast<size_t>(length);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (mapping == MAP_FAILED) return false;
+        data = static_cast<const uint8_t*>(mapping);
+        size = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+        if (!data) return;
+#if defined(_WIN32)
+        free(const_cast<uint8_t*>(data));
+#else
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+};
+
+// Level class owning everything that changes between levels, so it can be built off the main thread
+class Level {
+public:
+    int number;
+    std::vector<Wall> walls;
+    std::vector<Coin> coins;
+    SlowingZone slowingZone;
+    bool hasZone;
+    Door door;
+    bool hasDoor;
+    std::vector<Cop> cops; // Cops this level adds to the one that chases through every level
+    NavGrid nav;
+    ChunkGrid chunks;
+    MappedFile* file; // Level file that nav and chunks borrow from, when loaded from disk
+    int worldWidth;
+    int worldHeight;
+    Vector2 robberSpawn;
+    Vector2 copSpawn;
+    std::vector<Vector2> chokepoints; // Narrow passages between the robber spawn and the coins and door
+    InfluenceMap influence; // Coin layer settled, robber and cop layers empty
+    bool respawn; // Move the robber and cop to the spawns on install (the map changed under them)
+
+    Level() : number(0), slowingZone({0.0f, 0.0f, 0.0f, 0.0f}, 1.0f), hasZone(false), door({0.0f, 0.0f, 0.0f, 0.0f}), hasDoor(false), file(nullptr), worldWidth(0), worldHeight(0),
+              robberSpawn({0.0f, 0.0f}), copSpawn({0.0f, 0.0f}), respawn(false) {}
+
+    Level(Level&& other) noexcept : Level() {
+        swap(other);
+    }
+
+    Level& operator=(Level&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    Level(const Level&) = delete;
+    Level& operator=(const Level&) = delete;
+
+    ~Level() {
+        delete file;
+    }
+
+    // Run once the nav grid, coins, door and spawn are final
+    void findChokepoints() {
+        std::vector<Vector2> goals;
+        for (const Coin& coin : coins) goals.push_back(coin.position);
+        if (hasDoor) goals.push_back({door.rect.x + door.rect.width / 2, door.rect.y + door.rect.height / 2});
+        chokepoints = ChokepointFinder().find(nav, robberSpawn, goals);
+    }
+
+    void swap(Level& other) {
+        std::swap(number, other.number);
+        walls.swap(other.walls);
+        coins.swap(other.coins);
+        std::swap(slowingZone, other.slowingZone);
+        std::swap(hasZone, other.hasZone);
+        std::swap(door, other.door);
+        std::swap(hasDoor, other.hasDoor);
+        cops.swap(other.cops);
+        std::swap(nav, other.nav);
+        std::swap(chunks, other.chunks);
+        std::swap(file, other.file);
+        std::swap(worldWidth, other.worldWidth);
+        std::swap(worldHeight, other.worldHeight);
+        std::swap(robberSpawn, other.robberSpawn);
+        std::swap(copSpawn, other.copSpawn);
+        chokepoints.swap(other.chokepoints);
+        std::swap(influence, other.influence);
+        std::swap(respawn, other.respawn);
+    }
+};
+
+// LevelFile class for the versioned binary level format (little-endian). A file is a Header,
+// a table of Sections, then 8-byte aligned section payloads. Payloads are structure-of-arrays:
+// `fields` arrays of `count` elements back to back (every x, then every y, ...). Nav and chunk
+// data are used in place from the mapping; walls, coins, zone and door become objects on load.
+class LevelFile {
+public:
+    enum : uint32_t { Magic = 0x564C5243, Version = 1 }; // "CRLV"
+
+    enum SectionType : uint32_t {
+        Walls = 1,       // float x, y, width, height
+        Zones,           // float x, y, width, height, slowEffect
+        Doors,           // float x, y, width, height, isOpen
+        CoinSpawns,      // float x, y
+        CopSpawns,       // float x, y; the first is the chasing cop, the rest are the level's own
+        RobberSpawn,     // float x, y
+        NavBlocked,      // uint8 per cell
+        NavClearance,    // uint16 per cell
+        ChunkWallStart,  // int per chunk + 1
+        ChunkWallItems,  // int
+        ChunkCoinStart,  // int per chunk + 1
+        ChunkCoinItems,  // int
+        Chokepoints,     // float x, y; optional, found again on load when missing
+        SectionTypeCount
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t number;
+        uint32_t respawn;
+        int32_t worldWidth;
+        int32_t worldHeight;
+        float navCellSize;
+        int32_t navWidth;
+        int32_t navHeight;
+        float chunkSize;
+        int32_t chunkCols;
+        int32_t chunkRows;
+        uint32_t sectionCount;
+        uint32_t reserved;
+    };
+
+    struct Section {
+        uint32_t type;
+        uint32_t count;
+        uint64_t offset;
+    };
+
+    static bool save(const Level& level, const char* path) {
+        std::vector<Section> sections;
+        std::vector<uint8_t> payload;
+
+        std::vector<float> soa;
+        for (const Wall& wall : level.walls) soa.push_back(wall.rect.x);
+        for (const Wall& wall : level.walls) soa.push_back(wall.rect.y);
+        for (const Wall& wall : level.walls) soa.push_back(wall.rect.width);
+        for (const Wall& wall : level.walls) soa.push_back(wall.rect.height);
+        add(sections, payload, Walls, level.walls.size(), soa.data(), soa.size() * sizeof(float));
+
+        soa.clear();
+        if (level.hasZone) {
+            const SlowingZone& zone = level.slowingZone;
+            soa = {zone.rect.x, zone.rect.y, zone.rect.width, zone.rect.height, zone.slowEffect};
+        }
+        add(sections, payload, Zones, level.hasZone ? 1 : 0, soa.data(), soa.size() * sizeof(float));
+
+        soa.clear();
+        if (level.hasDoor) {
+            const Door& door = level.door;
+            soa = {door.rect.x, door.rect.y, door.rect.width, door.rect.height, door.isOpen ? 1.0f : 0.0f};
+        }
+        add(sections, payload, Doors, level.hasDoor ? 1 : 0, soa.data(), soa.size() * sizeof(float));
+
+        soa.clear();
+        for (const Coin& coin : level.coins) soa.push_back(coin.position.x);
+        for (const Coin& coin : level.coins) soa.push_back(coin.position.y);
+        add(sections, payload, CoinSpawns, level.coins.size(), soa.data(), soa.size() * sizeof(float));
+
+        soa.clear();
+        soa.push_back(level.copSpawn.x);
+        for (const Cop& cop : level.cops) soa.push_back(cop.position.x);
+        soa.push_back(level.copSpawn.y);
+        for (const Cop& cop : level.cops) soa.push_back(cop.position.y);
+        add(sections, payload, CopSpawns, level.cops.size() + 1, soa.data(), soa.size() * sizeof(float));
+
+        soa = {level.robberSpawn.x, level.robberSpawn.y};
+        add(sections, payload, RobberSpawn, 1, soa.data(), soa.size() * sizeof(float));
+
+        add(sections, payload, NavBlocked, level.nav.blocked.size(), level.nav.blocked.data(), level.nav.blocked.size());
+        add(sections, payload, NavClearance, level.nav.clearance.size(), level.nav.clearance.data(), level.nav.clearance.size() * sizeof(uint16_t));
+        add(sections, payload, ChunkWallStart, level.chunks.wallStart.size(), level.chunks.wallStart.data(), level.chunks.wallStart.size() * sizeof(int));
+        add(sections, payload, ChunkWallItems, level.chunks.wallItems.size(), level.chunks.wallItems.data(), level.chunks.wallItems.size() * sizeof(int));
+        add(sections, payload, ChunkCoinStart, level.chunks.coinStart.size(), level.chunks.coinStart.data(), level.chunks.coinStart.size() * sizeof(int));
+        add(sections, payload, ChunkCoinItems, level.chunks.coinItems.size(), level.chunks.coinItems.data(), level.chunks.coinItems.size() * sizeof(int));
+
+        soa.clear();
+        for (const Vector2& point : level.chokepoints) soa.push_back(point.x);
+        for (const Vector2& point : level.chokepoints) soa.push_back(point.y);
+        add(sections, payload, Chokepoints, level.chokepoints.size(), soa.data(), soa.size() * sizeof(float));
+
+        Header header;
+        memset(&header, 0, sizeof(header));
+        header.magic = Magic;
+        header.version = Version;
+        header.number = static_cast<uint32_t>(level.number);
+        header.respawn = level.respawn ? 1 : 0;
+        header.worldWidth = level.worldWidth;
+        header.worldHeight = level.worldHeight;
+        header.navCellSize = level.nav.cellSize;
+        header.navWidth = level.nav.width;
+        header.navHeight = level.nav.height;
+        header.chunkSize = level.chunks.chunkSize;
+        header.chunkCols = level.chunks.cols;
+        header.chunkRows = level.chunks.rows;
+        header.sectionCount = static_cast<uint32_t>(sections.size());
+
+        // Payload offsets become absolute once the header and table sizes are known
+        uint64_t base = sizeof(Header) + sections.size() * sizeof(Section);
+        for (Section& section : sections) section.offset += base;
+
+        FILE* out = fopen(path, "wb");
+        if (!out) return false;
+        bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+                  fwrite(sections.data(), sizeof(Section), sections.size(), out) == sections.size() &&
+                  fwrite(payload.data(), 1, payload.size(), out) == payload.size();
+        return fclose(out) == 0 && ok;
+    }
+
+    static bool load(const char* path, Level& level, const Tuning& tuning) {
+        MappedFile* file = new MappedFile();
+        if (!file->open(path)) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Failed to open level file", path);
+            delete file;
+            return false;
+        }
+
+        const Section* table[SectionTypeCount] = {};
+        const Header* header = validate(*file, table, path);
+        if (!header) {
+            delete file;
+            return false;
+        }
+
+        level.number = static_cast<int>(header->number);
+        level.respawn = header->respawn != 0;
+        level.worldWidth = header->worldWidth;
+        level.worldHeight = header->worldHeight;
+
+        size_t walls = table[Walls]->count;
+        const float* wall = floats(*file, table[Walls]);
+        level.walls.reserve(walls);
+        for (size_t i = 0; i < walls; i++) {
+            level.walls.push_back(Wall({wall[i], wall[walls + i], wall[2 * walls + i], wall[3 * walls + i]}));
+        }
+
+        if (table[Zones]->count > 0) {
+            const float* zone = floats(*file, table[Zones]);
+            level.slowingZone = SlowingZone({zone[0], zone[1], zone[2], zone[3]}, zone[4]);
+            level.hasZone = true;
+        }
+
+        if (table[Doors]->count > 0) {
+            const float* door = floats(*file, table[Doors]);
+            level.door = Door({door[0], door[1], door[2], door[3]});
+            level.door.isOpen = door[4] != 0.0f;
+            level.hasDoor = true;
+        }
+
+        size_t coins = table[CoinSpawns]->count;
+        const float* coin = floats(*file, table[CoinSpawns]);
+        for (size_t i = 0; i < coins; i++) {
+            level.coins.push_back(Coin({coin[i], coin[coins + i]}, tuning.coinRadius));
+        }
+
+        size_t cops = table[CopSpawns]->count;
+        const float* cop = floats(*file, table[CopSpawns]);
+        level.copSpawn = {cop[0], cop[cops]};
+        for (size_t i = 1; i < cops; i++) {
+            level.cops.push_back(Cop({cop[i], cop[cops + i]}, tuning.copRadius, PINK, tuning.copSpeed));
+        }
+
+        const float* robber = floats(*file, table[RobberSpawn]);
+        level.robberSpawn = {robber[0], robber[1]};
+
+        level.nav.cellSize = header->navCellSize;
+        level.nav.width = header->navWidth;
+        level.nav.height = header->navHeight;
+        level.nav.blocked.borrow(file->data + table[NavBlocked]->offset, table[NavBlocked]->count);
+        level.nav.clearance.borrow(reinterpret_cast<const uint16_t*>(file->data + table[NavClearance]->offset), table[NavClearance]->count);
+
+        level.chunks.chunkSize = header->chunkSize;
+        level.chunks.cols = header->chunkCols;
+        level.chunks.rows = header->chunkRows;
+        level.chunks.wallStart.borrow(ints(*file, table[ChunkWallStart]), table[ChunkWallStart]->count);
+        level.chunks.wallItems.borrow(ints(*file, table[ChunkWallItems]), table[ChunkWallItems]->count);
+        level.chunks.coinStart.borrow(ints(*file, table[ChunkCoinStart]), table[ChunkCoinStart]->count);
+        level.chunks.coinItems.borrow(ints(*file, table[ChunkCoinItems]), table[ChunkCoinItems]->count);
+        level.chunks.resetState(walls);
+
+        if (table[Chokepoints]) {
+            size_t points = table[Chokepoints]->count;
+            const float* point = floats(*file, table[Chokepoints]);
+            for (size_t i = 0; i < points; i++) level.chokepoints.push_back({point[i], point[points + i]});
+        } else {
+            level.findChokepoints();
+        }
+
+        level.file = file;
+        return true;
+    }
+
+private:
+    static void add(std::vector<Section>& sections, std::vector<uint8_t>& payload, SectionType type, size_t count, const void* data, size_t bytes) {
+        payload.resize((payload.size() + 7) & ~static_cast<size_t>(7), 0);
+        sections.push_back({type, static_cast<uint32_t>(count), payload.size()});
+        const uint8_t* bytesIn = static_cast<const uint8_t*>(data);
+        payload.insert(payload.end(), bytesIn, bytesIn + bytes);
+    }
+
+    static const float* floats(const MappedFile& file, const Section* section) {
+        return reinterpret_cast<const float*>(file.data + section->offset);
+    }
+
+    static const int* ints(const MappedFile& file, const Section* section) {
+        return reinterpret_cast<const int*>(file.data + section->offset);
+    }
+
+    // Whether `count` elements at `offset` lie inside the file, written so that no sum can wrap
+    static bool fits(const MappedFile& file, const Section* section, uint64_t elementBytes) {
+        return section->offset <= file.size && section->count <= (file.size - section->offset) / elementBytes;
+    }
+
+    // Check everything the loader is about to index, so a truncated or foreign file is rejected
+    // up front instead of read out of bounds
+    static const Header* validate(const MappedFile& file, const Section* table[], const char* path) {
+        if (file.size < sizeof(Header)) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] File too small", path);
+            return nullptr;
+        }
+        const Header* header = reinterpret_cast<const Header*>(file.data);
+        if (header->magic != Magic || header->version != Version) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Not a version %u level file", path, static_cast<unsigned>(Version));
+            return nullptr;
+        }
+        if (header->navWidth <= 0 || header->navHeight <= 0 || header->chunkCols <= 0 || header->chunkRows <= 0 ||
+            header->navCellSize <= 0.0f || header->chunkSize <= 0.0f) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Bad grid dimensions", path);
+            return nullptr;
+        }
+        if (sizeof(Header) + static_cast<uint64_t>(header->sectionCount) * sizeof(Section) > file.size) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Truncated section table", path);
+            return nullptr;
+        }
+
+        const Section* sections = reinterpret_cast<const Section*>(file.data + sizeof(Header));
+        for (uint32_t i = 0; i < header->sectionCount; i++) {
+            // Unknown sections are skipped, so newer writers can add data without a version bump
+            if (sections[i].type > 0 && sections[i].type < SectionTypeCount) table[sections[i].type] = &sections[i];
+        }
+
+        uint64_t cells = static_cast<uint64_t>(header->navWidth) * header->navHeight;
+        uint64_t chunks = static_cast<uint64_t>(header->chunkCols) * header->chunkRows;
+        const struct { SectionType type; uint64_t elementBytes; uint64_t minCount; uint64_t exactCount; } expected[] = {
+            {Walls, 4 * sizeof(float), 0, 0},
+            {Zones, 5 * sizeof(float), 0, 0},
+            {Doors, 5 * sizeof(float), 0, 0},
+            {CoinSpawns, 2 * sizeof(float), 0, 0},
+            {CopSpawns, 2 * sizeof(float), 1, 0},
+            {RobberSpawn, 2 * sizeof(float), 1, 0},
+            {NavBlocked, 1, 0, cells},
+            {NavClearance, sizeof(uint16_t), 0, cells},
+            {ChunkWallStart, sizeof(int), 0, chunks + 1},
+            {ChunkWallItems, sizeof(int), 0, 0},
+            {ChunkCoinStart, sizeof(int), 0, chunks + 1},
+            {ChunkCoinItems, sizeof(int), 0, 0},
+        };
+        for (const auto& check : expected) {
+            const Section* section = table[check.type];
+            if (!section || section->offset % 8 != 0 || section->count < check.minCount ||
+                (check.exactCount && section->count != check.exactCount) || !fits(file, section, check.elementBytes)) {
+                TraceLog(LOG_WARNING, "LEVEL: [%s] Missing or malformed section %u", path, static_cast<unsigned>(check.type));
+                return nullptr;
+            }
+        }
+
+        const Section* chokepoints = table[Chokepoints];
+        if (chokepoints && (chokepoints->offset % 8 != 0 || !fits(file, chokepoints, 2 * sizeof(float)))) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Malformed chokepoint section", path);
+            return nullptr;
+        }
+
+        // Chunk lists index walls and coins, so their entries have to be in range too
+        const int* wallStart = ints(file, table[ChunkWallStart]);
+        const int* coinStart = ints(file, table[ChunkCoinStart]);
+        if (wallStart[chunks] != static_cast<int>(table[ChunkWallItems]->count) ||
+            coinStart[chunks] != static_cast<int>(table[ChunkCoinItems]->count)) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] Chunk index does not match its item lists", path);
+            return nullptr;
+        }
+        for (uint64_t c = 0; c < chunks; c++) {
+            if (wallStart[c] < 0 || wallStart[c] > wallStart[c + 1] || coinStart[c] < 0 || coinStart[c] > coinStart[c + 1]) {
+                TraceLog(LOG_WARNING, "LEVEL: [%s] Chunk index is not monotonic", path);
+                return nullptr;
+            }
+        }
+        const int* wallItems = ints(file, table[ChunkWallItems]);
+        for (uint32_t i = 0; i < table[ChunkWallItems]->count; i++) {
+            if (wallItems[i] < 0 || wallItems[i] >= static_cast<int>(table[Walls]->count)) {
+                TraceLog(LOG_WARNING, "LEVEL: [%s] Chunk wall index out of range", path);
+                return nullptr;
+            }
+        }
+        const int* coinItems = ints(file, table[ChunkCoinItems]);
+        for (uint32_t i = 0; i < table[ChunkCoinItems]->count; i++) {
+            if (coinItems[i] < 0 || coinItems[i] >= static_cast<int>(table[CoinSpawns]->count)) {
+                TraceLog(LOG_WARNING, "LEVEL: [%s] Chunk coin index out of range", path);
+                return nullptr;
+            }
+        }
+        return header;
+    }
+};
+
+// LevelDefinition class for what a level adds on top of its walls and coins
+class LevelDefinition {
+public:
+    enum Feature { Zone = 1, SecondCop = 2, Door = 4 };
+    enum { FeatureSets = 8 }; // Every combination, for tables indexed by feature bits
+
+    int features;
+
+    constexpr bool has(Feature feature) const { return (features & feature) != 0; }
+
+    static constexpr LevelDefinition forLevel(int number);
+};
+
+// The built-in levels; level N is levelTable[N - 1]
+constexpr LevelDefinition levelTable[] = {
+    {0},
+    {LevelDefinition::Zone},
+    {LevelDefinition::Zone | LevelDefinition::SecondCop | LevelDefinition::Door},
+};
+constexpr int levelCount = sizeof(levelTable) / sizeof(levelTable[0]);
+
+constexpr LevelDefinition LevelDefinition::forLevel(int number) {
+    return levelTable[std::min(std::max(number, 1), levelCount) - 1];
+}
+
+// LevelBuilder class generating a complete level from plain settings; safe to run on a worker thread
+class LevelBuilder {
+public:
+    static const int mazeAttempts = 16; // Maps generated before falling back to the classic layout
+
+    int worldWidth;
+    int worldHeight;
+    int wallThickness;
+    Tuning tuning;
+    uint64_t seed;
+    LevelGenerator::Style style;
+    float chunkSize;
+    std::string levelDir; // Levels found here as level<N>.crl are loaded instead of generated
+
+    LevelBuilder(int w, int h, int thickness, const Tuning& levelTuning, uint64_t runSeed, LevelGenerator::Style levelStyle)
+        : worldWidth(w), worldHeight(h), wallThickness(thickness), tuning(levelTuning), seed(runSeed), style(levelStyle), chunkSize(512.0f) {}
+
+    Level build(int number) const {
+        Level level;
+        if (!levelDir.empty()) {
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/level%d.crl", levelDir.c_str(), number);
+            if (FileExists(path)) {
+                if (LevelFile::load(path, level, tuning)) {
+                    level.influence.build(level.nav, level.coins);
+                    return level;
+                }
+                TraceLog(LOG_WARNING, "LEVEL: Generating level %d instead", number);
+            }
+        }
+
+        LevelDefinition definition = LevelDefinition::forLevel(number);
+        level.number = number;
+        level.worldWidth = worldWidth;
+        level.worldHeight = worldHeight;
+        Random rng(seed * 31 + number);
+
+        if (style == LevelGenerator::Classic || !generateMaze(level, rng, definition)) {
+            generateWalls(level);
+            level.nav.build(level.walls, static_cast<float>(worldWidth), static_cast<float>(worldHeight), static_cast<float>(wallThickness));
+            level.robberSpawn = {worldWidth / 2.0f, worldHeight / 2.0f};
+            level.copSpawn = tuning.spawn(tuning.copSpawn, worldWidth, worldHeight);
+            generateCoins(level, rng);
+            if (definition.has(LevelDefinition::SecondCop)) {
+                level.cops.push_back(Cop(tuning.spawn(tuning.cop2Spawn, worldWidth, worldHeight), tuning.copRadius, PINK, tuning.copSpeed));
+            }
+            if (definition.has(LevelDefinition::Door)) {
+                generateDoor(level, {worldWidth / 2.0f, worldHeight - 60.0f});
+            }
+        }
+
+        if (definition.has(LevelDefinition::Zone)) {
+            // Seeded per run rather than per level so the zone stays put once it appears
+            Random zoneRng(seed ^ 0x5A0E5A0E5A0Eull);
+            generateSlowingZone(level, zoneRng);
+        }
+
+        level.chunks.build(level.walls, level.coins, static_cast<float>(worldWidth), static_cast<float>(worldHeight), chunkSize);
+        level.findChokepoints();
+        level.influence.build(level.nav, level.coins);
+        return level;
+    }
+
+private:
+    // False when no map had room for the spawns; only the nav grid and respawn are set then
+    bool generateMaze(Level& level, Random& rng, LevelDefinition definition) const {
+        // Walls are one wallThickness cell thick; corridors are just wide enough that their middle
+        // cell keeps a character clear of the walls on both sides
+        float cell = static_cast<float>(wallThickness);
+        int minClearance = static_cast<int>(ceilf(std::max(tuning.playerRadius, tuning.copRadius) / cell)) + 2;
+        int passage = 2 * minClearance - 1;
+
+        // Caves can come out as a handful of pockets on small maps; reroll until there is room to play
+        LevelGenerator generator(static_cast<float>(worldWidth), static_cast<float>(worldHeight), cell, passage, rng.next());
+        bool placed = false;
+        for (int attempt = 0; attempt < mazeAttempts && !placed; attempt++) {
+            generator = LevelGenerator(static_cast<float>(worldWidth), static_cast<float>(worldHeight), cell, passage, rng.next());
+            generator.generate(style);
+            level.nav.buildFromCells(generator.solid, generator.cols, generator.rows, cell);
+            placed = generator.place(level.nav.clearance, minClearance, tuning.maxCoins, 2);
+        }
+        if (!placed) {
+            // Characters too wide for this world's corridors; the classic layout always has room
+            TraceLog(LOG_WARNING, "LEVEL: No %s map with room for the spawns after %d tries, level %d uses the classic layout",
+                     LevelGenerator::styleName(style), mazeAttempts, level.number);
+            level.respawn = true;
+            return false;
+        }
+
+        std::vector<Rectangle> merged = generator.mergeWalls();
+        level.walls.reserve(merged.size());
+        for (const Rectangle& rect : merged) {
+            level.walls.push_back(Wall(rect));
+        }
+        for (const Vector2& coin : generator.coinSpawns) {
+            level.coins.push_back(Coin(coin, tuning.coinRadius));
+        }
+
+        level.respawn = true;
+        level.robberSpawn = generator.robberSpawn;
+        level.copSpawn = generator.copSpawns.empty() ? generator.robberSpawn : generator.copSpawns[0];
+        if (definition.has(LevelDefinition::SecondCop)) {
+            Vector2 spawn = generator.copSpawns.size() > 1 ? generator.copSpawns[1] : level.copSpawn;
+            level.cops.push_back(Cop(spawn, tuning.copRadius, PINK, tuning.copSpeed));
+        }
+        if (definition.has(LevelDefinition::Door)) {
+            generateDoor(level, generator.doorCenter);
+        }
+        return true;
+    }
+
+    void generateCoins(Level& level, Random& rng) const {
+        int margin = static_cast<int>(ceilf(tuning.coinRadius));
+        for (int i = 0; i < tuning.maxCoins; i++) {
+            Vector2 coinPosition;
+            do {
+                coinPosition = {static_cast<float>(rng.range(worldWidth - 2 * margin) + margin),
+                                static_cast<float>(rng.range(worldHeight - 2 * margin) + margin)};
+            } while (level.nav.isBlocked(coinPosition));
+            level.coins.push_back(Coin(coinPosition, tuning.coinRadius));
+        }
+    }
+
+    void generateWalls(Level& level) const {
+        level.walls.push_back(Wall({150.0f, 150.0f, 200.0f, static_cast<float>(wallThickness)}));
+        level.walls.push_back(Wall({450.0f, 300.0f, static_cast<float>(wallThickness), 200.0f}));
+        level.walls.push_back(Wall({250.0f, 450.0f, 300.0f, static_cast<float>(wallThickness)}));
+    }
+
+    void generateSlowingZone(Level& level, Random& rng) const {
+        // Half the world on screen-sized maps, half a screen on large ones
+        float zoneWidth = std::min(worldWidth, 800) / 2.0f;
+        float zoneHeight = std::min(worldHeight, 600) / 2.0f;
+        level.slowingZone = SlowingZone({static_cast<float>(rng.range(worldWidth - static_cast<int>(zoneWidth))),
+                                         static_cast<float>(rng.range(worldHeight - static_cast<int>(zoneHeight))),
+                                         zoneWidth, zoneHeight}, tuning.slowEffect);
+        level.hasZone = true;
+    }
+
+    void generateDoor(Level& level, Vector2 center) const {
+        level.door = Door({center.x - 40.0f, center.y - 20.0f, 80.0f, 40.0f});
+        level.door.isOpen = true;
+        level.hasDoor = true;
+    }
+};
+
+// GameState class for a flat snapshot of everything that changes during play. The bytes are a
+// Header, `coinCount` CoinStates and `copCount` CharacterStates, all plain data with no pointers
+// and no padding, so a snapshot can be copied, written out or kept for rollback as-is; reading
+// one back is a check of the header and casts at the two offsets. Walls and nav are not
+// included: the run seed and level number rebuild them. Nor is the influence map: a restore
+// rebuilds it from the map and coins, with the robber trail and cop coverage starting empty.
+class GameState {
+public:
+    enum : uint32_t { Magic = 0x54535243, Version = 3 }; // "CRST"
+
+    struct CharacterState {
+        Vector2 position;
+        float speed;
+        float rotation;
+        int32_t radius;
+        uint32_t lead; // The cop that chases through every level
+        Vector2 velocity; // A cop's last step; for the robber, its recent average
+    };
+
+    struct CoinState {
+        Vector2 position;
+        float radius;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t seed;
+        uint32_t size;        // Header, coins and cops, in bytes
+        uint32_t coinCount;
+        uint32_t coinOffset;
+        uint32_t copCount;
+        uint32_t copOffset;
+        int32_t level;
+        int32_t score;
+        int32_t levelCoins;
+        uint8_t gameOver;
+        uint8_t robberEscaped;
+        uint8_t hasZone;
+        uint8_t hasDoor;
+        CharacterState robber;
+        Rectangle zone;
+        float slowEffect;
+        Rectangle door;
+        uint32_t doorOpen;
+        uint32_t unused;      // Keeps the size a multiple of 8 without compiler padding
+    };
+
+    static_assert(std::is_trivially_copyable<Header>::value && std::is_trivially_copyable<CoinState>::value &&
+                  std::is_trivially_copyable<CharacterState>::value, "GameState must stay plain data");
+    static_assert(sizeof(Header) == 128 && sizeof(CoinState) == 12 && sizeof(CharacterState) == 32, "GameState layout changed");
+
+    GameState() : used(0) {}
+
+    static size_t bytesFor(size_t coinCount, size_t copCount) {
+        return sizeof(Header) + coinCount * sizeof(CoinState) + copCount * sizeof(CharacterState);
+    }
+
+    // Start a snapshot; the buffer only grows, so steady-state saves don't allocate
+    Header* write(size_t coinCount, size_t copCount) {
+        used = bytesFor(coinCount, copCount);
+        if (bytes.size() < used) bytes.resize(used);
+        Header* header = reinterpret_cast<Header*>(bytes.data());
+        memset(header, 0, sizeof(Header));
+        header->magic = Magic;
+        header->version = Version;
+        header->size = static_cast<uint32_t>(used);
+        header->coinCount = static_cast<uint32_t>(coinCount);
+        header->coinOffset = sizeof(Header);
+        header->copCount = static_cast<uint32_t>(copCount);
+        header->copOffset = static_cast<uint32_t>(sizeof(Header) + coinCount * sizeof(CoinState));
+        return header;
+    }
+
+    CoinState* coins() {
+        return reinterpret_cast<CoinState*>(bytes.data() + sizeof(Header));
+    }
+
+    CharacterState* cops() {
+        return reinterpret_cast<CharacterState*>(bytes.data() + reinterpret_cast<const Header*>(bytes.data())->copOffset);
+    }
+
+    // The header, or nullptr when the bytes are not a complete snapshot
+    const Header* read() const {
+        if (used < sizeof(Header)) return nullptr;
+        const Header* header = reinterpret_cast<const Header*>(bytes.data());
+        if (header->magic != Magic || header->version != Version || header->size != used ||
+            header->coinOffset != sizeof(Header) || header->copOffset != sizeof(Header) + header->coinCount * sizeof(CoinState) ||
+            header->size != bytesFor(header->coinCount, header->copCount)) {
+            return nullptr;
+        }
+        return header;
+    }
+
+    const CoinState* coins(const Header* header) const {
+        return reinterpret_cast<const CoinState*>(reinterpret_cast<const uint8_t*>(header) + header->coinOffset);
+    }
+
+    const CharacterState* cops(const Header* header) const {
+        return reinterpret_cast<const CharacterState*>(reinterpret_cast<const uint8_t*>(header) + header->copOffset);
+    }
+
+    const uint8_t* data() const { return bytes.data(); }
+    size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+
+    void assign(const uint8_t* data, size_t size) {
+        if (bytes.size() < size) bytes.resize(size);
+        memcpy(bytes.data(), data, size);
+        used = size;
+    }
+
+    bool save(const char* path) const {
+        FILE* out = fopen(path, "wb");
+        if (!out) return false;
+        bool ok = fwrite(bytes.data(), 1, used, out) == used;
+        return fclose(out) == 0 && ok;
+    }
+
+    bool load(const char* path) {
+        FILE* in = fopen(path, "rb");
+        if (!in) return false;
+        fseek(in, 0, SEEK_END);
+        long length = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        bool ok = length > 0;
+        if (ok) {
+            if (bytes.size() < static_cast<size_t>(length)) bytes.resize(length);
+            used = static_cast<size_t>(length);
+            ok = fread(bytes.data(), 1, used, in) == used;
+        }
+        fclose(in);
+        if (!ok || !read()) {
+            used = 0;
+            TraceLog(LOG_WARNING, "STATE: [%s] Not a version %u game state", path, static_cast<unsigned>(Version));
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> bytes; // operator new alignment covers the 8-byte seed
+    size_t used;
+};
+
+// StateHistory class for the rewind debugger: the last `capacity` ticks of GameState in a ring.
+// Most ticks only move a few characters, so a frame is stored as the 32-bit words that changed
+// since the tick before; a full keyframe is kept every keyInterval ticks (and whenever the state
+// changes size) to bound how many deltas a restore replays. The oldest frame is always a keyframe.
+class StateHistory {
+public:
+    static const int keyInterval = 60;
+
+    explicit StateHistory(int capacity) : frames(capacity), first(0), count(0), sinceKey(0) {}
+
+    int size() const { return count; }
+
+    void clear() {
+        count = 0;
+        first = 0;
+    }
+
+    // Append the newest tick, dropping the oldest when the ring is full
+    void record(const GameState& state) {
+        if (count == static_cast<int>(frames.size())) evictOldest();
+
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(state.data());
+        size_t wordCount = state.size() / sizeof(uint32_t);
+        Frame& frame = at(count);
+        frame.data.clear();
+        frame.key = count == 0 || sinceKey + 1 >= keyInterval || wordCount != previous.size();
+        if (frame.key) {
+            frame.data.assign(words, words + wordCount);
+            sinceKey = 0;
+        } else {
+            for (size_t i = 0; i < wordCount; i++) {
+                if (words[i] != previous[i]) {
+                    frame.data.push_back(static_cast<uint32_t>(i));
+                    frame.data.push_back(words[i]);
+                }
+            }
+            sinceKey++;
+        }
+        previous.assign(words, words + wordCount);
+        count++;
+    }
+
+    // Rebuild frame `index` (0 is the oldest kept tick) from its keyframe and the deltas after it
+    bool restore(int index, GameState& out) {
+        if (index < 0 || index >= count) return false;
+        int key = index;
+        while (!at(key).key) key--;
+        scratch = at(key).data;
+        for (int i = key + 1; i <= index; i++) applyDelta(at(i), scratch);
+        out.assign(reinterpret_cast<const uint8_t*>(scratch.data()), scratch.size() * sizeof(uint32_t));
+        return true;
+    }
+
+    // Forget every tick after `index`, so recording continues from there
+    void truncate(int index) {
+        if (index < 0 || index >= count - 1) return;
+        count = index + 1;
+        sinceKey = 0;
+        for (int i = index; !at(i).key; i--) sinceKey++;
+        GameState state;
+        restore(index, state);
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(state.data());
+        previous.assign(words, words + state.size() / sizeof(uint32_t));
+    }
+
+    // Heap held by the ring, for the debugger overlay
+    size_t bytes() const {
+        size_t total = frames.size() * sizeof(Frame) + (previous.capacity() + scratch.capacity()) * sizeof(uint32_t);
+        for (const Frame& frame : frames) total += frame.data.capacity() * sizeof(uint32_t);
+        return total;
+    }
+
+private:
+    struct Frame {
+        bool key;
+        std::vector<uint32_t> data; // Keyframe: the state's words. Delta: (word index, value) pairs.
+    };
+
+    std::vector<Frame> frames;
+    int first;
+    int count;
+    int sinceKey;
+    std::vector<uint32_t> previous; // Words of the newest frame, the base of the next delta
+    std::vector<uint32_t> scratch;
+
+    Frame& at(int index) { return frames[(first + index) % frames.size()]; }
+
+    static void applyDelta(const Frame& frame, std::vector<uint32_t>& words) {
+        for (size_t i = 0; i + 1 < frame.data.size(); i += 2) words[frame.data[i]] = frame.data[i + 1];
+    }
+
+    // Fold the oldest keyframe into its successor so the ring still starts on a keyframe
+    void evictOldest() {
+        Frame& oldest = at(0);
+        Frame& next = at(1);
+        if (count > 1 && !next.key) {
+            applyDelta(next, oldest.data);
+            next.data.swap(oldest.data);
+            next.key = true;
+        }
+        first = (first + 1) % static_cast<int>(frames.size());
+        count--;
+    }
+};
+
+// GameOptions class for the command line switches
+class GameOptions {
+public:
+    LevelGenerator::Style style;
+    uint64_t seed;
+    bool fixedSeed;
+    bool bench;
+    bool headless; // No window: for exporting, benchmarks and other tooling runs
+    bool hard;     // Cops plan with MctsPlanner
+    bool bot;      // The robber plays itself
+    int soakTicks; // Play this many headless ticks with the bot, restarting after each run
+    int worldWidth;
+    int worldHeight;
+    std::string levelDir;
+    std::string exportDir;
+    std::string configPath;
+    std::string policyPath; // CopNet weights that steer the cops
+    std::string tablePath;  // CopTable that steers the cops
+    std::string trainPath;  // Train a CopTable on every level, write it here and exit
+    std::string tunePath;   // Tune the balance for captureRate, write the config here and exit
+    float captureRate;
+
+    GameOptions() : style(LevelGenerator::Classic), seed(0), fixedSeed(false), bench(false), headless(false), hard(false), bot(false), soakTicks(0), worldWidth(800), worldHeight(600),
+                    configPath("game.cfg"), captureRate(0.5f) {}
+
+    bool parse(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--maze") == 0 && i + 1 < argc) {
+                const char* name = argv[++i];
+                if (strcmp(name, "division") == 0) style = LevelGenerator::RecursiveDivision;
+                else if (strcmp(name, "rooms") == 0) style = LevelGenerator::RoomsAndCorridors;
+                else if (strcmp(name, "caves") == 0) style = LevelGenerator::CellularCaves;
+                else return usage(argv[0]);
+            } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                seed = strtoull(argv[++i], nullptr, 10);
+                fixedSeed = true;
+            } else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc) {
+                if (sscanf(argv[++i], "%dx%d", &worldWidth, &worldHeight) != 2 || worldWidth <= 0 || worldHeight <= 0) return usage(argv[0]);
+            } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+                configPath = argv[++i];
+            } else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+                levelDir = argv[++i];
+            } else if (strcmp(argv[i], "--export-levels") == 0 && i + 1 < argc) {
+                exportDir = argv[++i];
+                headless = true;
+            } else if (strcmp(argv[i], "--bench") == 0) {
+                bench = true;
+            } else if (strcmp(argv[i], "--hard") == 0) {
+                hard = true;
+            } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+                policyPath = argv[++i];
+            } else if (strcmp(argv[i], "--cop-table") == 0 && i + 1 < argc) {
+                tablePath = argv[++i];
+            } else if (strcmp(argv[i], "--train-table") == 0 && i + 1 < argc) {
+                trainPath = argv[++i];
+                headless = true;
+            } else if (strcmp(argv[i], "--tune") == 0 && i + 1 < argc) {
+                tunePath = argv[++i];
+                headless = true;
+            } else if (strcmp(argv[i], "--capture-rate") == 0 && i + 1 < argc) {
+                captureRate = strtof(argv[++i], nullptr);
+                if (captureRate < 0.0f || captureRate > 1.0f) return usage(argv[0]);
+            } else if (strcmp(argv[i], "--bot") == 0) {
+                bot = true;
+            } else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+                soakTicks = atoi(argv[++i]);
+                if (soakTicks <= 0) return usage(argv[0]);
+                bot = true;
+                headless = true;
+            } else {
+                return usage(argv[0]);
+            }
+        }
+        return true;
+    }
+
+private:
+    static bool usage(const char* program) {
+        printf("usage: %s [--maze division|rooms|caves] [--seed N] [--world WIDTHxHEIGHT] [--config FILE] [--levels DIR] [--export-levels DIR] [--hard] [--policy FILE] [--cop-table FILE] [--train-table FILE] [--tune FILE] [--capture-rate R] [--bot] [--soak TICKS] [--bench]\n", program);
+        return false;
+    }
+};
+
+// Game class to run the game
+class Game {
+public:
+    const int screenWidth = 800;
+    const int screenHeight = 600;
+    const int wallThickness = 20;
+    const int targetFPS = 60;
+    const int lastLevel = levelCount;
+    const int activeChunkRadius = 1; // With 512 px chunks this covers the whole view around the robber
+    const char* const quickSavePath = "quicksave.state";
+    const int historySeconds = 60;
+    const double planBudgetMs = 2.0; // Per tick, on every core, in hard mode
+    const double analysisBudgetMs = 500.0; // Per exported level
+    const float guardBase = 0.5f;  // Weight of a chokepoint guard far from coins and the robber's trail
+    const float guardTrail = 0.5f; // Extra weight where the robber has just been
+    const uint64_t trainingSteps = 200000000; // Env steps per level for --train-table
+
+    Robber robber;
+    Registry<Cop> cops;
+    EntityHandle leadCop;                // The cop that chases through every level
+    std::vector<EntityHandle> levelCops; // Cops the current level added; despawned with it
+    Door door; // Door for level 3
+    bool hasDoor;
+    Registry<Coin> coins; // Collected coins are despawned
+    int levelCoins;       // Coins the current level started with
+    std::vector<Wall> walls;
+    SlowingZone slowingZone;
+    bool hasZone;
+    NavGrid nav;
+    ChunkGrid chunks;
+    MappedFile* levelFile; // Backing store of nav and chunks when the level came from a file
+    int worldWidth;
+    int worldHeight;
+    Camera2D camera;
+    SpriteBatch batch;
+    int score;
+    bool gameOver;
+    bool robberEscaped;
+    int level;
+    uint64_t seed;
+    GameOptions options;
+    Tuning tuning;
+    FileWatcher configWatcher; // Edits to the config file apply to the running game
+    std::future<Level> nextLevel; // Level N+1, built in the background while level N is played
+    GameState quickSave; // F5 / F9 slot, also written to quickSavePath
+    StateHistory history; // The last historySeconds of ticks, for rewinding
+    GameState tickState;  // Scratch for recording and restoring history frames
+    int cursor;           // History frame currently shown; the newest one unless rewound
+    bool paused;
+    int features;         // LevelDefinition bits of what is installed; picks the specialized tick and draw
+
+    // Per-tick scratch for chunk queries
+    std::vector<int> nearbyChunks;
+    std::vector<const Wall*> nearbyWalls;
+    std::vector<EntityHandle> nearbyCoins;
+    std::vector<EntityHandle> activeCoins; // Coins in the active chunks, the only ones given a proxy
+    SweepAndPrune broadphase; // Character and coin pairs, sorted across ticks
+    OrcaAvoidance avoidance;  // Cops steering around each other
+    Pursuit pursuit;          // Where each cop heads: the robber's intercept point or the way around
+    Coordinator coordinator;  // Which cops chase and which cut the robber off
+    std::vector<Vector2> chokepoints; // The level's narrow passages, for cops to guard
+    RobberBot robberBot;              // Drives the robber when options.bot is set
+    InfluenceMap influence;           // Robber trail, cop coverage and coin fields for the AI
+    MctsPlanner* planner;             // Hard mode only
+    CopNet* policy;                   // Loaded from options.policyPath; replaces the pursuit and coordinator aims
+    std::vector<Vector2> policyHeadings;
+    CopTable* copTable;               // Loaded from options.tablePath
+    const CopTable::Table* currentTable; // The current level's, when copTable has one for this map
+    GridChase tableGrid;              // The coarse cells currentTable is indexed by
+    std::vector<int16_t> tableCells;  // Per-tick scratch: each cop's coarse cell
+    uint8_t plannedActions[MctsPlanner::maxPlanned];
+    int plannedCount;                 // Cops the planner's trees were grown for; 0 to start over
+    int ticksToDecision;
+
+    Game(const GameOptions& gameOptions) : robber({0.0f, 0.0f}, 0, BLUE, 0.0f), door({0.0f, 0.0f, 0.0f, 0.0f}), hasDoor(false), levelCoins(0),
+                                         slowingZone({0.0f, 0.0f, 0.0f, 0.0f}, 1.0f), hasZone(false), levelFile(nullptr), score(0), gameOver(false), robberEscaped(false), level(1), options(gameOptions),
+                                         history(historySeconds * targetFPS), cursor(0), paused(false), features(0), planner(nullptr), policy(nullptr),
+                                         copTable(nullptr), currentTable(nullptr), plannedCount(0), ticksToDecision(0) {
+        if (!options.headless) {
+            InitWindow(screenWidth, screenHeight, "Cop and Robber Game");
+            SetTargetFPS(targetFPS);
+            batch.load();
+        }
+        seed = options.fixedSeed ? options.seed : static_cast<uint64_t>(time(0));
+        worldWidth = std::max(options.worldWidth, screenWidth);
+        worldHeight = std::max(options.worldHeight, screenHeight);
+        camera = {{screenWidth / 2.0f, screenHeight / 2.0f}, {screenWidth / 2.0f, screenHeight / 2.0f}, 0.0f, 1.0f};
+        if (FileExists(options.configPath.c_str())) tuning.load(options.configPath.c_str());
+        configWatcher.watch(options.configPath);
+        if (options.hard) {
+            int cores = static_cast<int>(std::thread::hardware_concurrency());
+            planner = new MctsPlanner(std::max(0, cores - 1), seed);
+        }
+        if (!options.policyPath.empty()) {
+            policy = new CopNet();
+            if (policy->load(options.policyPath.c_str())) {
+                TraceLog(LOG_INFO, "POLICY: [%s] %d layers, %s kernels", options.policyPath.c_str(), static_cast<int>(policy->layers.size()), policy->simd ? "AVX2" : "scalar");
+            } else {
+                TraceLog(LOG_WARNING, "POLICY: [%s] Failed to load, cops keep their own aim", options.policyPath.c_str());
+                delete policy;
+                policy = nullptr;
+            }
+        }
+        if (!options.tablePath.empty()) {
+            copTable = new CopTable();
+            if (copTable->load(options.tablePath.c_str())) {
+                TraceLog(LOG_INFO, "COPTABLE: [%s] %d levels", options.tablePath.c_str(), static_cast<int>(copTable->tables.size()));
+            } else {
+                TraceLog(LOG_WARNING, "COPTABLE: [%s] Failed to load, cops keep their own aim", options.tablePath.c_str());
+                delete copTable;
+                copTable = nullptr;
+            }
+        }
+
+        robber = Robber({worldWidth / 2.0f, worldHeight / 2.0f}, tuning.playerRadius, BLUE, tuning.robberSpeed);
+        leadCop = cops.spawn(Cop(tuning.spawn(tuning.copSpawn, worldWidth, worldHeight), tuning.copRadius, RED, tuning.copSpeed));
+
+        Level first = builder().build(1);
+        installLevel(first);
+        prepareLevel(2, std::move(first));
+        record();
+    }
+
+    ~Game() {
+        if (nextLevel.valid()) nextLevel.wait();
+        delete levelFile;
+        delete planner;
+        delete policy;
+        delete copTable;
+        if (!options.headless) {
+            batch.unload();
+            CloseWindow();
+        }
+    }
+
+    void run() {
+        while (!WindowShouldClose()) {
+            update();
+            draw();
+        }
+    }
+
+    // Write every level this run would generate to dir/level<N>.crl
+    bool exportLevels(const char* dir) const {
+        LevelBuilder levelBuilder = builder();
+        levelBuilder.levelDir.clear();
+        for (int number = 1; number <= lastLevel; number++) {
+            Level exported = levelBuilder.build(number);
+            std::string path = std::string(dir) + "/level" + std::to_string(number) + ".crl";
+            if (!LevelFile::save(exported, path.c_str())) {
+                TraceLog(LOG_WARNING, "LEVEL: [%s] Failed to write level file", path.c_str());
+                return false;
+            }
+            TraceLog(LOG_INFO, "LEVEL: [%s] Level %d written (%d walls)", path.c_str(), number, static_cast<int>(exported.walls.size()));
+            GridSearch::Result difficulty;
+            if (!analyze(exported, analysisBudgetMs, difficulty)) {
+                TraceLog(LOG_WARNING, "LEVEL: Level %d has no open coarse cell for a cop; not scored", number);
+                continue;
+            }
+            TraceLog(LOG_INFO, "LEVEL: Level %d grid score %d at depth %d (%s)", number, difficulty.score, difficulty.depth,
+                     difficulty.score >= GridChase::winScore - 1000 ? "robber wins" : difficulty.score <= 1000 - GridChase::winScore ? "cops win" : "open");
+        }
+        return true;
+    }
+
+    // Learn a CopTable for every level this run plays by self-play on its coarse grid, and write
+    // it to `path`
+    bool trainTables(const char* path) const {
+        LevelBuilder levelBuilder = builder();
+        CopTable trained;
+        int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int number = 1; number <= lastLevel; number++) {
+            Level built = levelBuilder.build(number);
+            GridChase grid;
+            grid.build(built.nav, static_cast<float>(tuning.copRadius), CopTable::maxCells);
+            trained.tables.push_back(CopTable::blank(number, grid));
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            QTrainer trainer;
+            QTrainer::Report report = trainer.train(grid, 1 + static_cast<int>(built.cops.size()), trainingSteps, threads, seed + number, trained.tables.back());
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            TraceLog(LOG_INFO, "COPTABLE: Level %d trained on %d cells with %d cops in %.1f s: %llu steps, %llu of %llu episodes caught", number, grid.width * grid.height, 1 + static_cast<int>(built.cops.size()), seconds,
+                     static_cast<unsigned long long>(report.steps), static_cast<unsigned long long>(report.captures), static_cast<unsigned long long>(report.episodes));
+        }
+        if (!trained.save(path)) {
+            TraceLog(LOG_WARNING, "COPTABLE: [%s] Failed to write", path);
+            return false;
+        }
+        TraceLog(LOG_INFO, "COPTABLE: [%s] Written", path);
+        return true;
+    }
+
+    // Headless play with the robber bot, restarting after every capture, escape or cleared run
+    void soak(int ticks) {
+        int caught = 0, escaped = 0, cleared = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            step();
+            if (!gameOver && !robberEscaped) continue;
+            if (robberEscaped) escaped++;
+            else if (level > lastLevel) cleared++;
+            else caught++;
+            resetGame();
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("soak: %d ticks in %.1f ms (%.3f ms/tick), %d caught, %d escaped, %d cleared\n", ticks, elapsed, elapsed / ticks, caught, escaped, cleared);
+    }
+
+    // Start a run over on level `number` of the maps `runSeed` gives, with the robber and the
+    // lead cop back at their spawns. Without `prefetch` the next level is not built ahead; a
+    // run that gets there builds it then.
+    void startAt(int number, uint64_t runSeed, bool prefetch) {
+        score = 0;
+        level = number;
+        gameOver = false;
+        robberEscaped = false;
+        robber.position = {worldWidth / 2.0f, worldHeight / 2.0f};
+        cops.clear();
+        levelCops.clear();
+        leadCop = cops.spawn(Cop(tuning.spawn(tuning.copSpawn, worldWidth, worldHeight), tuning.copRadius, RED, tuning.copSpeed));
+
+        // The pending build belongs to the old run
+        if (nextLevel.valid()) nextLevel.get();
+        seed = runSeed;
+        Level first = builder().build(number);
+        installLevel(first);
+        if (prefetch) prepareLevel(number + 1, std::move(first));
+    }
+
+    // Minimax from the level's start on the turn-based grid: what a perfect robber scores against
+    // perfect cops within `budgetMs`. Above zero favours the robber. False when the coarse grid
+    // has no open cell (cops too wide for every passage).
+    bool analyze(const Level& analyzed, double budgetMs, GridSearch::Result& result) const {
+        GridChase chase;
+        chase.build(analyzed.nav, tuning.copRadius);
+        std::vector<Vector2> copsAt(1, analyzed.copSpawn);
+        for (const Cop& added : analyzed.cops) copsAt.push_back(added.position);
+        std::vector<Vector2> coinsAt;
+        for (const Coin& coin : analyzed.coins) coinsAt.push_back(coin.position);
+        GridChase::Position start;
+        if (!chase.start(analyzed.robberSpawn, copsAt, coinsAt, tuning.maxCoins, start)) return false;
+        GridSearch search;
+        result = search.run(chase, start, budgetMs, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+        return true;
+    }
+
+    // Snapshot everything update() can change. Fixed-size records copied into a buffer that is
+    // reused, so this is cheap enough to run every tick.
+    void saveState(GameState& state) const {
+        GameState::Header* header = state.write(coins.size(), cops.size());
+        header->seed = seed;
+        header->level = level;
+        header->score = score;
+        header->levelCoins = levelCoins;
+        header->gameOver = gameOver;
+        header->robberEscaped = robberEscaped;
+        header->robber = characterState(robber, 0.0f, false, pursuit.velocity());
+        if (hasZone) {
+            header->hasZone = 1;
+            header->zone = slowingZone.rect;
+            header->slowEffect = slowingZone.slowEffect;
+        }
+        if (hasDoor) {
+            header->hasDoor = 1;
+            header->door = door.rect;
+            header->doorOpen = door.isOpen;
+        }
+        GameState::CoinState* coinsOut = state.coins();
+        for (size_t i = 0; i < coins.size(); i++) {
+            coinsOut[i] = {coins[i].position, coins[i].radius};
+        }
+        GameState::CharacterState* copsOut = state.cops();
+        for (size_t i = 0; i < cops.size(); i++) {
+            copsOut[i] = characterState(cops[i], cops[i].rotation, cops.slotOf(i) == leadCop.slot, cops[i].velocity);
+        }
+    }
+
+    // Restore a snapshot. Same level and seed only overwrites fields in place; otherwise the
+    // snapshot's map is rebuilt first, which blocks for one level build. Cops are respawned, so
+    // handles to them taken before the restore go stale.
+    bool loadState(const GameState& state) {
+        const GameState::Header* header = state.read();
+        if (!header) return false;
+
+        if ((header->seed != seed || header->level != level) && header->level <= lastLevel) {
+            if (nextLevel.valid()) nextLevel.get();
+            seed = header->seed;
+            Level restored = builder().build(header->level);
+            installLevel(restored);
+            prepareLevel(header->level + 1, std::move(restored));
+        }
+        seed = header->seed;
+        level = header->level;
+        score = header->score;
+        levelCoins = header->levelCoins;
+        gameOver = header->gameOver != 0;
+        robberEscaped = header->robberEscaped != 0;
+
+        restoreCharacter(robber, header->robber);
+        pursuit.seed(robber.position, header->robber.velocity);
+
+        const GameState::CharacterState* copsIn = state.cops(header);
+        cops.clear();
+        levelCops.clear();
+        for (uint32_t i = 0; i < header->copCount; i++) {
+            Cop restoredCop(copsIn[i].position, copsIn[i].radius, copsIn[i].lead ? RED : PINK, copsIn[i].speed);
+            restoredCop.rotation = copsIn[i].rotation;
+            restoredCop.velocity = copsIn[i].velocity;
+            EntityHandle handle = cops.spawn(restoredCop);
+            if (copsIn[i].lead) leadCop = handle;
+            else levelCops.push_back(handle);
+        }
+        plannedCount = 0;
+        robberBot.reset();
+
+        hasZone = header->hasZone != 0;
+        slowingZone.rect = header->zone;
+        slowingZone.slowEffect = header->slowEffect;
+        hasDoor = header->hasDoor != 0;
+        door.rect = header->door;
+        door.isOpen = header->doorOpen != 0;
+
+        // Coins only need respawning (and re-indexing) when some were collected or spawned since
+        const GameState::CoinState* coinsIn = state.coins(header);
+        bool same = coins.size() == header->coinCount;
+        for (size_t i = 0; same && i < coins.size(); i++) {
+            same = coins[i].position.x == coinsIn[i].position.x && coins[i].position.y == coinsIn[i].position.y;
+        }
+        if (same) {
+            for (size_t i = 0; i < coins.size(); i++) coins[i].radius = coinsIn[i].radius;
+        } else {
+            coins.clear();
+            for (uint32_t i = 0; i < header->coinCount; i++) coins.spawn(Coin(coinsIn[i].position, coinsIn[i].radius));
+            chunks.indexCoins(coins);
+        }
+        // The influence layers are not in the snapshot; rebuilding them from the map and coins
+        // gives every restore of a snapshot the same AI inputs
+        influence.rebuild(nav, coins);
+        refreshFeatures();
+        return true;
+    }
+
+private:
+    void update() {
+        if (configWatcher.changed()) reloadTuning();
+        if (IsKeyPressed(KEY_F5)) quickSaveGame();
+        if (IsKeyPressed(KEY_F9)) quickLoadGame();
+
+        // Rewind debugger: hold Backspace to run time backwards, P to pause, and while paused
+        // Left/Right step through recorded ticks (Right from the newest simulates one more)
+        if (IsKeyPressed(KEY_P)) paused = !paused;
+        if (IsKeyDown(KEY_BACKSPACE)) {
+            seek(cursor - 1);
+            return;
+        }
+        if (paused) {
+            if (IsKeyPressed(KEY_LEFT)) seek(cursor - 1);
+            if (IsKeyPressed(KEY_RIGHT)) {
+                if (cursor < history.size() - 1) seek(cursor + 1);
+                else step();
+            }
+            return;
+        }
+        step();
+    }
+
+public:
+    // Advance the simulation one tick. Playing on from a rewound frame drops the ticks after it.
+    void step() {
+        history.truncate(cursor);
+        if (!gameOver && !robberEscaped) {
+            // One specialization per feature set, so the tick carries no checks for absent objects
+            typedef void (Game::*Tick)();
+            static const Tick ticks[LevelDefinition::FeatureSets] = {
+                &Game::tick<0>, &Game::tick<1>, &Game::tick<2>, &Game::tick<3>,
+                &Game::tick<4>, &Game::tick<5>, &Game::tick<6>, &Game::tick<7>,
+            };
+            (this->*ticks[features])();
+        } else {
+            if (IsKeyPressed(KEY_R)) {
+                resetGame();
+            }
+        }
+        record();
+    }
+
+private:
+    template <int Features>
+    void tick() {
+        const bool withZone = (Features & LevelDefinition::Zone) != 0;
+        const bool withDoor = (Features & LevelDefinition::Door) != 0;
+
+        activateChunks();
+
+        gatherNearby(robber);
+        Vector2 input = options.bot ? robberBot.steer(nav, robber.position, static_cast<float>(robber.radius), coins, influence) : Robber::keys();
+        robber.move(worldSize(), nearbyWalls, input);
+        pursuit.observe(robber.position);
+
+        if (withZone && slowingZone.isInside(robber.position)) {
+            robber.speed = tuning.robberSpeed * slowingZone.slowEffect;
+        } else {
+            robber.speed = tuning.robberSpeed;
+        }
+
+        aimCops<Features>();
+        if (cops.size() < 2) {
+            for (size_t i = 0; i < cops.size(); i++) {
+                gatherNearby(cops[i]);
+                cops[i].move(pursuit.aimOf(i), nearbyWalls, worldSize());
+            }
+        } else {
+            moveCrowd();
+        }
+        influence.update(chunks, robber.position, cops, coins);
+
+        // Captures, cops crowding each other and coin pickups all come from the broadphase pairs
+        broadphase.beginTick();
+        broadphase.update(SweepAndPrune::RobberProxy, 0, robber.position, static_cast<float>(robber.radius));
+        for (size_t i = 0; i < cops.size(); i++) {
+            broadphase.update(SweepAndPrune::CopProxy, cops.slotOf(i), cops[i].position, static_cast<float>(cops[i].radius));
+        }
+        chunks.gatherCoins(chunks.active, coins, activeCoins);
+        for (EntityHandle handle : activeCoins) {
+            const Coin* coin = coins.get(handle);
+            broadphase.update(SweepAndPrune::CoinProxy, handle.slot, coin->position, coin->radius);
+        }
+        broadphase.sweep();
+
+        for (const SweepAndPrune::Pair& pair : broadphase.pairs) {
+            if (pair.kindA == SweepAndPrune::RobberProxy && pair.kindB == SweepAndPrune::CopProxy) {
+                const Cop* catcher = cops.get(cops.handleAt(pair.b));
+                if (CheckCollisionCircles(robber.position, robber.radius, catcher->position, catcher->radius)) gameOver = true;
+            } else if (pair.kindA == SweepAndPrune::CopProxy && pair.kindB == SweepAndPrune::CopProxy) {
+                separate(*cops.get(cops.handleAt(pair.a)), *cops.get(cops.handleAt(pair.b)));
+            } else if (pair.kindA == SweepAndPrune::RobberProxy && pair.kindB == SweepAndPrune::CoinProxy) {
+                EntityHandle handle = coins.handleAt(pair.b);
+                const Coin* coin = coins.get(handle);
+                if (CheckCollisionCircles(robber.position, robber.radius, coin->position, coin->radius)) {
+                    coins.despawn(handle);
+                    score++;
+                }
+            }
+        }
+
+        // A reload can raise coins_per_level above what the current level holds. The next level
+        // may have other features, so the rest waits for the next tick's specialization.
+        if (score >= std::min(tuning.maxCoins, levelCoins)) {
+            advanceLevel();
+            return;
+        }
+
+        if (withDoor && door.isOpen && CheckCollisionCircleRec(robber.position, robber.radius, door.rect)) {
+            robberEscaped = true;
+        }
+    }
+
+    template <int Features>
+    void aimCops() {
+        pursuit.resize(cops.size());
+        for (size_t i = 0; i < cops.size(); i++) {
+            pursuit.x[i] = cops[i].position.x;
+            pursuit.y[i] = cops[i].position.y;
+            pursuit.speed[i] = cops[i].speed;
+        }
+        uint16_t clearance = static_cast<uint16_t>(1 + ceilf(tuning.copRadius / nav.cellSize));
+        pursuit.aim(nav, clearance);
+
+        // One cop is enough to chase; the rest cover the door and the robber's ways out
+        if (policy) followPolicy();
+        else if (cops.size() >= 2) coordinate<Features>();
+        if (currentTable) followTable();
+        if (planner) plan();
+    }
+
+    template <int Features>
+    void coordinate() {
+        const bool withDoor = (Features & LevelDefinition::Door) != 0;
+
+        coordinator.available[Coordinator::DoorSlot] = withDoor && door.isOpen;
+        if (withDoor) coordinator.points[Coordinator::DoorSlot] = {door.rect.x + door.rect.width / 2, door.rect.y + door.rect.height / 2};
+        for (int d = 0; d < Pursuit::escapeDirections; d++) {
+            coordinator.available[Coordinator::FirstEscape + d] = pursuit.escapeFound[d];
+            coordinator.points[Coordinator::FirstEscape + d] = pursuit.escapePoints[d];
+        }
+        for (size_t g = 0; g < ChokepointFinder::maxChokepoints; g++) {
+            coordinator.available[Coordinator::FirstGuard + g] = g < chokepoints.size();
+            if (g >= chokepoints.size()) continue;
+            // A passage is worth more near coins still to collect and where the robber has just been
+            coordinator.points[Coordinator::FirstGuard + g] = chokepoints[g];
+            coordinator.weights[Coordinator::FirstGuard + g] = guardBase + influence.at(InfluenceMap::CoinValue, chokepoints[g]) +
+                                                               guardTrail * influence.at(InfluenceMap::RobberPresence, chokepoints[g]);
+        }
+        coordinator.assign(pursuit, robber.position, pursuit.velocity());
+        for (size_t i = 0; i < cops.size(); i++) {
+            int slot = coordinator.slotOf[i];
+            if (slot >= Coordinator::LeadSlot) continue;
+            pursuit.aimX[i] = coordinator.points[slot].x;
+            pursuit.aimY[i] = coordinator.points[slot].y;
+        }
+    }
+
+    // Every cop heads where the learned policy says, from the features of the whole batch
+    void followPolicy() {
+        policy->gather(nav, pursuit, robber.position);
+        policy->run(policyHeadings);
+        for (size_t i = 0; i < cops.size(); i++) {
+            Vector2 aim = VectorUtils::Add(cops[i].position, VectorUtils::Scale(policyHeadings[i], 100.0f));
+            pursuit.aimX[i] = aim.x;
+            pursuit.aimY[i] = aim.y;
+        }
+    }
+
+    // Every cop not yet in the robber's coarse cell heads for the next cell the table gives: the
+    // cop fewest steps from the robber as the chaser, the rest as cutters. A chaser told to wait
+    // is playing for parity on the turn-based grid, which a robber standing still never gives
+    // it here, so it keeps its pursuit aim instead. A coarse grid with no open cell (cops too wide
+    // for every passage) has no cells to look up, and every cop keeps its aim.
+    void followTable() {
+        int16_t target = tableGrid.cellAt(robber.position);
+        if (target < 0) return;
+        tableCells.resize(cops.size());
+        size_t chaser = cops.size();
+        for (size_t i = 0; i < cops.size(); i++) {
+            tableCells[i] = tableGrid.cellAt(cops[i].position);
+            if (tableCells[i] < 0) continue;
+            if (chaser == cops.size() || tableGrid.steps(tableCells[i], target) < tableGrid.steps(tableCells[chaser], target)) chaser = i;
+        }
+        for (size_t i = 0; i < cops.size(); i++) {
+            if (tableCells[i] < 0) continue;
+            int role = i == chaser ? CopTable::Chaser : CopTable::Cutter;
+            uint8_t step = CopTable::get(*currentTable, role, tableCells[i], target);
+            if (tableCells[i] == target || step == CopTable::unknown || (role == CopTable::Chaser && step == GridChase::Stay)) continue;
+            // Cells are joined centre to centre, so a cop off its centre can have a wall corner in
+            // the way; one that cannot close on the cell keeps its pursuit aim
+            Vector2 aim = tableGrid.center(tableGrid.toward(tableCells[i], step));
+            gatherNearby(cops[i]);
+            float before = VectorUtils::Length(VectorUtils::Subtract(aim, cops[i].position));
+            Vector2 trial = VectorUtils::Scale(VectorUtils::Normalize(VectorUtils::Subtract(aim, cops[i].position)), cops[i].speed);
+            Vector2 reached = SweptCircle::move(cops[i].position, trial, static_cast<float>(cops[i].radius), nearbyWalls);
+            if (VectorUtils::Length(VectorUtils::Subtract(aim, reached)) > before - 0.5f * cops[i].speed) continue;
+            pursuit.aimX[i] = aim.x;
+            pursuit.aimY[i] = aim.y;
+        }
+    }
+
+    // Hard mode: the lead cop and the level's first cop search for the next decisionTicks every
+    // tick, and a heading the search settled on replaces the aim pursuit gave them
+    void plan() {
+        Cop* planned[MctsPlanner::maxPlanned];
+        int count = 0;
+        if (Cop* lead = cops.get(leadCop)) planned[count++] = lead;
+        if (!levelCops.empty()) {
+            if (Cop* second = cops.get(levelCops[0])) planned[count++] = second;
+        }
+        if (count == 0) return;
+        if (count != plannedCount) {
+            planner->reset();
+            plannedCount = count;
+            ticksToDecision = 0;
+            for (int c = 0; c < MctsPlanner::maxPlanned; c++) plannedActions[c] = MctsPlanner::Pursue;
+        }
+
+        MctsPlanner::Snapshot snapshot;
+        snapshot.robber = robber.position;
+        snapshot.robberSpeed = robber.speed;
+        snapshot.robberRadius = static_cast<float>(robber.radius);
+        snapshot.planned = count;
+        for (int c = 0; c < count; c++) {
+            snapshot.cops[c] = planned[c]->position;
+            snapshot.copSpeeds[c] = planned[c]->speed;
+            snapshot.copRadii[c] = static_cast<float>(planned[c]->radius);
+            snapshot.committed[c] = plannedActions[c];
+        }
+        snapshot.ticksToDecision = ticksToDecision;
+        planner->search(nav, snapshot, planBudgetMs);
+        if (ticksToDecision == 0) {
+            planner->commit(plannedActions);
+            ticksToDecision = MctsPlanner::decisionTicks;
+        }
+        ticksToDecision--;
+
+        for (int c = 0; c < count; c++) {
+            if (plannedActions[c] == MctsPlanner::Pursue) continue;
+            size_t i = static_cast<size_t>(planned[c] - &cops[0]);
+            Vector2 aim = VectorUtils::Add(planned[c]->position, VectorUtils::Scale(planner->heading(plannedActions[c]), 100.0f));
+            pursuit.aimX[i] = aim.x;
+            pursuit.aimY[i] = aim.y;
+        }
+    }
+
+    // Every cop steers for itself, then ORCA bends the steps so cops make room for each other.
+    // An adjusted step is swept against the walls like any other; one that would leave the
+    // world falls back to the cop's own step.
+    void moveCrowd() {
+        size_t count = cops.size();
+        avoidance.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            Cop& chaser = cops[i];
+            gatherNearby(chaser);
+            avoidance.preferred[i] = chaser.steer(pursuit.aimOf(i), nearbyWalls, worldSize());
+            avoidance.positions[i] = chaser.position;
+            avoidance.velocities[i] = chaser.velocity;
+            avoidance.radii[i] = static_cast<float>(chaser.radius);
+            avoidance.maxSpeeds[i] = chaser.speed;
+        }
+        avoidance.solve();
+
+        for (size_t i = 0; i < count; i++) {
+            Cop& chaser = cops[i];
+            Vector2 step = avoidance.out[i];
+            if (step.x != avoidance.preferred[i].x || step.y != avoidance.preferred[i].y) {
+                gatherNearby(chaser);
+                Vector2 target = SweptCircle::move(chaser.position, step, static_cast<float>(chaser.radius), nearbyWalls);
+                bool outside = target.x - chaser.radius < 0 || target.x + chaser.radius > worldWidth ||
+                               target.y - chaser.radius < 0 || target.y + chaser.radius > worldHeight;
+                step = outside ? avoidance.preferred[i] : VectorUtils::Subtract(target, chaser.position);
+            }
+            chaser.advance(step);
+        }
+    }
+
+    // Push two overlapping cops apart, half the overlap each
+    void separate(Cop& first, Cop& second) {
+        Vector2 delta = VectorUtils::Subtract(second.position, first.position);
+        float distance = VectorUtils::Length(delta);
+        float overlap = first.radius + second.radius - distance;
+        if (overlap <= 0.0f) return;
+        Vector2 normal = distance > 0.0f ? VectorUtils::Scale(delta, 1.0f / distance) : Vector2{1.0f, 0.0f};
+        nudge(first, VectorUtils::Scale(normal, -overlap / 2.0f));
+        nudge(second, VectorUtils::Scale(normal, overlap / 2.0f));
+    }
+
+    // Move a cop by `offset` unless that would leave the world or put it in a wall
+    void nudge(Cop& nudged, Vector2 offset) {
+        Vector2 target = VectorUtils::Add(nudged.position, offset);
+        if (target.x - nudged.radius < 0 || target.x + nudged.radius > worldWidth ||
+            target.y - nudged.radius < 0 || target.y + nudged.radius > worldHeight) {
+            return;
+        }
+        gatherNearby(nudged);
+        for (const Wall* wall : nearbyWalls) {
+            if (CheckCollisionCircleRec(target, static_cast<float>(nudged.radius), wall->rect)) return;
+        }
+        nudged.position = target;
+    }
+
+    void record() {
+        saveState(tickState);
+        history.record(tickState);
+        cursor = history.size() - 1;
+    }
+
+    // Show history frame `frame`, clamped to what the ring still holds
+    void seek(int frame) {
+        frame = std::min(std::max(frame, 0), history.size() - 1);
+        if (frame == cursor) return;
+        if (history.restore(frame, tickState) && loadState(tickState)) cursor = frame;
+    }
+
+    void draw() {
+        followRobber();
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        BeginMode2D(camera);
+
+        // Only chunks under the view are visited, and only objects overlapping it are submitted
+        Rectangle view = viewRect();
+        chunks.chunksUnder(view, nearbyChunks);
+
+        typedef void (Game::*DrawWorld)(Rectangle);
+        static const DrawWorld drawWorlds[LevelDefinition::FeatureSets] = {
+            &Game::drawWorld<0>, &Game::drawWorld<1>, &Game::drawWorld<2>, &Game::drawWorld<3>,
+            &Game::drawWorld<4>, &Game::drawWorld<5>, &Game::drawWorld<6>, &Game::drawWorld<7>,
+        };
+        (this->*drawWorlds[features])(view);
+
+        EndMode2D();
+
+        DrawText(TextFormat("Score: %d", score), 10, 10, 20, BLACK);
+        DrawText(TextFormat("Level: %d", level), 10, 40, 20, BLACK);
+        if (paused) {
+            DrawText(TextFormat("PAUSED  tick %d/%d  (%d KB history)", cursor + 1, history.size(), static_cast<int>(history.bytes() / 1024)),
+                     10, 70, 20, MAROON);
+        }
+
+        if (gameOver) {
+            DrawText("Game Over!", screenWidth / 2 - MeasureText("Game Over!", 40) / 2, screenHeight / 2 - 20, 40, RED);
+            DrawText("Press 'R' to restart", screenWidth / 2 - MeasureText("Press 'R' to restart", 20) / 2, screenHeight / 2 + 30, 20, DARKGRAY);
+        }
+
+        if (robberEscaped) {
+            ClearBackground(BLACK);
+            BeginMode2D(camera);
+            robber.draw();
+            EndMode2D();
+            DrawText("We have successfully robbed our neighbour! 😏", screenWidth / 2 - MeasureText("We have successfully robbed our neighbour! 😏", 20) / 2, screenHeight / 2, 20, GREEN);
+        }
+
+        EndDrawing();
+    }
+
+    template <int Features>
+    void drawWorld(Rectangle view) {
+        const bool withZone = (Features & LevelDefinition::Zone) != 0;
+        const bool withDoor = (Features & LevelDefinition::Door) != 0;
+
+        chunks.gatherWalls(nearbyChunks, walls, nearbyWalls);
+        for (const Wall* wall : nearbyWalls) {
+            if (CheckCollisionRecs(wall->rect, view)) wall->draw();
+        }
+
+        if (withZone && CheckCollisionRecs(slowingZone.rect, view)) {
+            slowingZone.draw();
+        }
+
+        if (withDoor && CheckCollisionRecs(door.rect, view)) {
+            door.draw();
+        }
+
+        // Coins and characters all share the circle texture: one batch, no per-entity tessellation
+        batch.begin();
+        chunks.gatherCoins(nearbyChunks, coins, nearbyCoins);
+        for (EntityHandle handle : nearbyCoins) {
+            const Coin* coin = coins.get(handle);
+            if (CheckCollisionCircleRec(coin->position, coin->radius, view)) coin->draw(batch);
+        }
+
+        robber.draw(batch);
+        for (const Cop& drawn : cops) {
+            if (isVisible(drawn, view)) drawn.draw(batch);
+        }
+        batch.end();
+
+        if (paused) {
+            for (const Cop& debugged : cops) drawCopDebug(debugged);
+        }
+    }
+
+    // What Cop::move() works with: the walls it tests against and its heading to the robber
+    void drawCopDebug(const Cop& debugCop) {
+        gatherNearby(debugCop);
+        for (const Wall* wall : nearbyWalls) DrawRectangleLinesEx(wall->rect, 2.0f, ORANGE);
+        DrawCircleLines(static_cast<int>(debugCop.position.x), static_cast<int>(debugCop.position.y), debugCop.radius + debugCop.speed, ORANGE);
+        DrawLineEx(debugCop.position, robber.position, 1.0f, Fade(debugCop.color, 0.5f));
+    }
+
+    static GameState::CharacterState characterState(const Character& character, float rotation, bool lead, Vector2 velocity) {
+        return {character.position, character.speed, rotation, character.radius, lead, velocity};
+    }
+
+    static void restoreCharacter(Character& character, const GameState::CharacterState& state) {
+        character.position = state.position;
+        character.speed = state.speed;
+        character.radius = state.radius;
+    }
+
+    void quickSaveGame() {
+        saveState(quickSave);
+        if (!quickSave.save(quickSavePath)) TraceLog(LOG_WARNING, "STATE: [%s] Failed to write game state", quickSavePath);
+    }
+
+    // The in-memory slot, or the file a previous session left behind
+    void quickLoadGame() {
+        if (quickSave.empty() && !quickSave.load(quickSavePath)) return;
+        if (!loadState(quickSave)) TraceLog(LOG_WARNING, "STATE: Quick save is not a valid game state");
+    }
+
+    Vector2 worldSize() const {
+        return {static_cast<float>(worldWidth), static_cast<float>(worldHeight)};
+    }
+
+    // World-space rectangle covered by the window
+    Rectangle viewRect() const {
+        Vector2 topLeft = GetScreenToWorld2D({0.0f, 0.0f}, camera);
+        Vector2 bottomRight = GetScreenToWorld2D({static_cast<float>(screenWidth), static_cast<float>(screenHeight)}, camera);
+        return {topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y};
+    }
+
+    bool isVisible(const Character& character, Rectangle view) const {
+        return CheckCollisionCircleRec(character.position, static_cast<float>(character.radius), view);
+    }
+
+    // Keep the robber centred, but never show anything past the world edge
+    void followRobber() {
+        camera.target.x = std::min(std::max(robber.position.x, screenWidth / 2.0f), worldWidth - screenWidth / 2.0f);
+        camera.target.y = std::min(std::max(robber.position.y, screenHeight / 2.0f), worldHeight - screenHeight / 2.0f);
+    }
+
+    void activateChunks() {
+        chunks.beginTick();
+        chunks.activate(robber.position, activeChunkRadius);
+        for (const Cop& active : cops) chunks.activate(active.position, activeChunkRadius);
+    }
+
+    // Feature bits of what is actually installed: a level file or a loaded state can differ from
+    // levelTable. Cops are iterated from the registry, so only the zone and door pick a specialization.
+    void refreshFeatures() {
+        features = (hasZone ? LevelDefinition::Zone : 0) | (hasDoor ? LevelDefinition::Door : 0);
+    }
+
+    // Walls in the chunks a character can touch during this tick
+    void gatherNearby(const Character& character) {
+        float reach = character.radius + character.speed;
+        chunks.chunksUnder({character.position.x - reach, character.position.y - reach, 2 * reach, 2 * reach}, nearbyChunks);
+        chunks.gatherWalls(nearbyChunks, walls, nearbyWalls);
+    }
+
+    LevelBuilder builder() const {
+        LevelBuilder levelBuilder(std::max(options.worldWidth, screenWidth), std::max(options.worldHeight, screenHeight),
+                                  wallThickness, tuning, seed, options.style);
+        levelBuilder.levelDir = options.levelDir;
+        return levelBuilder;
+    }
+
+    // Kick off the build of a level on a worker thread. The level being retired is handed over
+    // as well, so freeing its walls and coins doesn't land in a frame either.
+    void prepareLevel(int number, Level retired) {
+        LevelBuilder levelBuilder = builder();
+        int last = lastLevel;
+        nextLevel = std::async(std::launch::async, [levelBuilder, number, last, stale = std::move(retired)]() mutable {
+            Level discard(std::move(stale));
+            return number <= last ? levelBuilder.build(number) : Level();
+        });
+    }
+
+    // Replace the pending build with one from the current settings. The stale build is waited
+    // for and dropped on the new worker, so the frame that asked never blocks on it.
+    void rebuildNextLevel() {
+        LevelBuilder levelBuilder = builder();
+        int number = level + 1;
+        nextLevel = std::async(std::launch::async, [levelBuilder, number, stale = std::move(nextLevel)]() mutable {
+            Level discard(stale.get());
+            return levelBuilder.build(number);
+        });
+    }
+
+    // Swap a finished level in; the previous level's contents end up in `next`
+    void installLevel(Level& next) {
+        walls.swap(next.walls);
+        std::swap(slowingZone, next.slowingZone);
+        std::swap(hasZone, next.hasZone);
+        std::swap(door, next.door);
+        std::swap(hasDoor, next.hasDoor);
+        std::swap(nav, next.nav);
+        std::swap(chunks, next.chunks);
+        std::swap(levelFile, next.file);
+        std::swap(worldWidth, next.worldWidth);
+        std::swap(worldHeight, next.worldHeight);
+        chokepoints.swap(next.chokepoints);
+        std::swap(influence, next.influence);
+        pursuit.reset();
+
+        // Coins go into a cleared registry in level order, matching the slots the chunk index uses
+        coins.clear();
+        for (const Coin& coin : next.coins) coins.spawn(coin);
+        levelCoins = static_cast<int>(coins.size());
+        for (EntityHandle handle : levelCops) cops.despawn(handle);
+        levelCops.clear();
+        for (const Cop& added : next.cops) levelCops.push_back(cops.spawn(added));
+        plannedCount = 0;
+        robberBot.reset();
+        if (copTable) selectTable(next.number);
+
+        if (next.respawn) {
+            robber.position = next.robberSpawn;
+            if (Cop* lead = cops.get(leadCop)) lead->position = next.copSpawn;
+        }
+        applyTuning(tuning);
+        refreshFeatures();
+    }
+
+    // Point currentTable at the table trained for this level's map, if there is one
+    void selectTable(int number) {
+        tableGrid.build(nav, static_cast<float>(tuning.copRadius), CopTable::maxCells);
+        currentTable = copTable->find(number, tableGrid.layoutKey());
+        if (!currentTable) TraceLog(LOG_WARNING, "COPTABLE: No table for level %d on this map, cops keep their own aim", number);
+    }
+
+    void reloadTuning() {
+        Tuning next;
+        if (!next.load(options.configPath.c_str())) {
+            TraceLog(LOG_WARNING, "CONFIG: [%s] Keeping previous values", options.configPath.c_str());
+            return;
+        }
+
+        // Coin count, spawns and radii are baked into a built level (procedural corridors are
+        // sized from the radii), so only those invalidate the pre-built next level
+        bool rebuild = next.maxCoins != tuning.maxCoins || next.playerRadius != tuning.playerRadius ||
+                       next.copRadius != tuning.copRadius || next.coinRadius != tuning.coinRadius ||
+                       next.copSpawn.x != tuning.copSpawn.x || next.copSpawn.y != tuning.copSpawn.y ||
+                       next.cop2Spawn.x != tuning.cop2Spawn.x || next.cop2Spawn.y != tuning.cop2Spawn.y;
+        bool copsResized = next.copRadius != tuning.copRadius;
+        applyTuning(next);
+        tuning = next;
+        // The table grid's cells are sized for the cops
+        if (copTable && copsResized) selectTable(level);
+        if (rebuild && level < lastLevel && nextLevel.valid()) {
+            rebuildNextLevel();
+        }
+        TraceLog(LOG_INFO, "CONFIG: [%s] Reloaded%s", options.configPath.c_str(), rebuild ? ", next level rebuilt" : "");
+    }
+
+    // Push tuning values into the live characters and zone; coins only when their radius changed
+    void applyTuning(const Tuning& next) {
+        robber.radius = next.playerRadius;
+        for (Cop& tuned : cops) {
+            tuned.radius = next.copRadius;
+            tuned.speed = next.copSpeed;
+        }
+        if (hasZone) slowingZone.slowEffect = next.slowEffect;
+        coordinator.setValues(next);
+        if (!coins.empty() && coins[0].radius != next.coinRadius) {
+            for (Coin& coin : coins) coin.radius = next.coinRadius;
+        }
+    }
+
+    void advanceLevel() {
+        level++;
+        score = 0;
+
+        if (level > lastLevel) {
+            gameOver = true;
+            return;
+        }
+
+        // Usually ready long before the last coin is picked up; only blocks if it isn't
+        Level next = nextLevel.valid() ? nextLevel.get() : builder().build(level);
+        installLevel(next);
+        prepareLevel(level + 1, std::move(next));
+    }
+
+    // A fresh seed gives new coins and zone
+    void resetGame() {
+        startAt(1, seed + 1, true);
+    }
+};
+
+// BalanceTuner class for searching the gameplay numbers that give every level a target capture
+// rate against the robber bot: the cops' speed, the Coordinator slot values and, on classic
+// levels, the two cop spawns. The search is a separable CMA-ES (Ros and Hansen) over the knobs
+// scaled to [0, 1]. A candidate plays gamesPerLevel games from the start of each level; every
+// candidate of a generation plays the same seeds (common random numbers), so the ranking is
+// down to the numbers rather than the maps drawn. Games run on every core, one Game per thread.
+class BalanceTuner {
+public:
+    static constexpr int generations = 30;
+    static constexpr int gamesPerLevel = 24;
+    static constexpr int gameTicks = 3600;           // A minute at 60 fps; a robber still free then got away
+    static constexpr float initialStep = 0.2f;       // CMA-ES sigma, in knob ranges
+    static constexpr float spawnClearance = 150.0f;  // Tuned cop spawns keep this far from the robber's
+
+    BalanceTuner(const GameOptions& runOptions, const Tuning& runTuning, uint64_t runSeed, float captureRate)
+        : base(runTuning), seed(runSeed), target(captureRate) {
+        GameOptions options = runOptions;
+        options.headless = true;
+        options.bot = true;
+        options.hard = false;
+        options.soakTicks = 0;
+        options.fixedSeed = true;
+        options.seed = runSeed;
+        options.configPath.clear();
+        options.trainPath.clear();
+        options.tunePath.clear();
+        int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int t = 0; t < threads; t++) games.push_back(new Game(options));
+        levels = games[0]->lastLevel;
+        worldWidth = static_cast<float>(games[0]->worldWidth);
+        worldHeight = static_cast<float>(games[0]->worldHeight);
+        // Maze levels place the cops themselves
+        dimensions = runOptions.style == LevelGenerator::Classic ? KnobCount : FirstSpawn;
+    }
+
+    ~BalanceTuner() {
+        for (Game* game : games) delete game;
+    }
+
+    BalanceTuner(const BalanceTuner&) = delete;
+    BalanceTuner& operator=(const BalanceTuner&) = delete;
+
+    // Search, then write the final mean to `path` as a config file
+    bool run(const char* path) {
+        int n = dimensions;
+        int lambda = 4 + static_cast<int>(3.0f * logf(static_cast<float>(n)));
+        int mu = lambda / 2;
+        std::vector<float> weights(mu);
+        float weightSum = 0.0f, weightSquares = 0.0f;
+        for (int i = 0; i < mu; i++) {
+            weights[i] = logf(mu + 0.5f) - logf(i + 1.0f);
+            weightSum += weights[i];
+        }
+        for (float& w : weights) {
+            w /= weightSum;
+            weightSquares += w * w;
+        }
+        float muEff = 1.0f / weightSquares;
+        float cSigma = (muEff + 2.0f) / (n + muEff + 5.0f);
+        float dSigma = 1.0f + 2.0f * std::max(0.0f, sqrtf((muEff - 1.0f) / (n + 1.0f)) - 1.0f) + cSigma;
+        float cc = (4.0f + muEff / n) / (n + 4.0f + 2.0f * muEff / n);
+        // Diagonal-only learning rates, raised by (n + 2) / 3 as separable CMA-ES allows
+        float c1 = std::min(1.0f, 2.0f / ((n + 1.3f) * (n + 1.3f) + muEff) * (n + 2.0f) / 3.0f);
+        float cMu = std::min(1.0f - c1, 2.0f * (muEff - 2.0f + 1.0f / muEff) / ((n + 2.0f) * (n + 2.0f) + muEff) * (n + 2.0f) / 3.0f);
+        float chiN = sqrtf(static_cast<float>(n)) * (1.0f - 1.0f / (4.0f * n) + 1.0f / (21.0f * n * n));
+
+        std::vector<float> mean = encode(base);
+        std::vector<float> variance(n, 1.0f), pathC(n, 0.0f), pathSigma(n, 0.0f);
+        float sigma = initialStep;
+        Random rng(seed ^ 0xC3A5C85C97CB3127ull);
+        std::vector<float> z(static_cast<size_t>(lambda) * n), y(z.size());
+        std::vector<Tuning> candidates(lambda);
+        std::vector<float> rates, costs(lambda);
+        std::vector<int> order(lambda);
+
+        for (int generation = 0; generation < generations; generation++) {
+            for (int k = 0; k < lambda; k++) {
+                std::vector<float> x(n);
+                for (int d = 0; d < n; d++) {
+                    z[k * n + d] = gaussian(rng);
+                    y[k * n + d] = sqrtf(variance[d]) * z[k * n + d];
+                    x[d] = mean[d] + sigma * y[k * n + d];
+                }
+                candidates[k] = decode(x);
+            }
+            // Fresh seeds each generation, shared by its candidates
+            uint64_t seedBase = seed + 1 + static_cast<uint64_t>(generation) * gamesPerLevel;
+            evaluate(candidates, seedBase, rates);
+            for (int k = 0; k < lambda; k++) {
+                costs[k] = cost(&rates[k * levels]);
+                order[k] = k;
+            }
+            std::sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[a] < costs[b]; });
+
+            std::vector<float> zMean(n, 0.0f), yMean(n, 0.0f);
+            for (int i = 0; i < mu; i++) {
+                for (int d = 0; d < n; d++) {
+                    zMean[d] += weights[i] * z[order[i] * n + d];
+                    yMean[d] += weights[i] * y[order[i] * n + d];
+                }
+            }
+            float sigmaNorm = 0.0f;
+            for (int d = 0; d < n; d++) {
+                mean[d] += sigma * yMean[d];
+                pathSigma[d] = (1.0f - cSigma) * pathSigma[d] + sqrtf(cSigma * (2.0f - cSigma) * muEff) * zMean[d];
+                sigmaNorm += pathSigma[d] * pathSigma[d];
+            }
+            sigmaNorm = sqrtf(sigmaNorm);
+            // A path that outran chiN means sigma is still growing: hold back the rank-one update
+            bool longPath = sigmaNorm / sqrtf(1.0f - powf(1.0f - cSigma, 2.0f * (generation + 1))) >= (1.4f + 2.0f / (n + 1)) * chiN;
+            for (int d = 0; d < n; d++) {
+                pathC[d] = (1.0f - cc) * pathC[d] + (longPath ? 0.0f : sqrtf(cc * (2.0f - cc) * muEff)) * yMean[d];
+                float rankMu = 0.0f;
+                for (int i = 0; i < mu; i++) rankMu += weights[i] * y[order[i] * n + d] * y[order[i] * n + d];
+                float correction = longPath ? c1 * cc * (2.0f - cc) * variance[d] : 0.0f;
+                variance[d] = (1.0f - c1 - cMu) * variance[d] + c1 * pathC[d] * pathC[d] + correction + cMu * rankMu;
+            }
+            sigma *= expf((cSigma / dSigma) * (sigmaNorm / chiN - 1.0f));
+
+            char summary[128];
+            describe(&rates[order[0] * levels], summary, sizeof(summary));
+            TraceLog(LOG_INFO, "TUNE: Generation %d: best cost %.4f (%s), step %.3f", generation + 1, costs[order[0]], summary, sigma);
+        }
+
+        std::vector<Tuning> tuned(1, decode(mean));
+        evaluate(tuned, seed + 1 + static_cast<uint64_t>(generations) * gamesPerLevel, rates);
+        char summary[128];
+        describe(rates.data(), summary, sizeof(summary));
+        char comment[192];
+        snprintf(comment, sizeof(comment), "Tuned for a capture rate of %.2f per level: %s", target, summary);
+        if (!tuned[0].save(path, comment)) {
+            TraceLog(LOG_WARNING, "TUNE: [%s] Failed to write", path);
+            return false;
+        }
+        TraceLog(LOG_INFO, "TUNE: [%s] Written, %s", path, summary);
+        return true;
+    }
+
+    // Capture rate of every candidate on every level (candidate-major), over gamesPerLevel
+    // games seeded seedBase onwards
+    void evaluate(const std::vector<Tuning>& candidates, uint64_t seedBase, std::vector<float>& rates) {
+        int jobs = static_cast<int>(candidates.size()) * levels * gamesPerLevel;
+        std::vector<uint8_t> caught(jobs, 0);
+        std::atomic<int> nextJob(0);
+        auto work = [&](Game* game) {
+            for (int j = nextJob.fetch_add(1); j < jobs; j = nextJob.fetch_add(1)) {
+                int candidate = j / (levels * gamesPerLevel);
+                int number = 1 + (j / gamesPerLevel) % levels;
+                caught[j] = play(*game, candidates[candidate], number, seedBase + j % gamesPerLevel);
+            }
+        };
+        std::vector<std::thread> helpers;
+        for (size_t t = 1; t < games.size(); t++) helpers.emplace_back(work, games[t]);
+        work(games[0]);
+        for (std::thread& helper : helpers) helper.join();
+
+        rates.assign(candidates.size() * levels, 0.0f);
+        for (int j = 0; j < jobs; j++) rates[j / gamesPerLevel] += caught[j] * (1.0f / gamesPerLevel);
+    }
+
+private:
+    enum Knob { CopSpeed, ChaseValue, SupportValue, EscapeValue, DoorValue, GuardValue, FirstSpawn, CopX = FirstSpawn, CopY, Cop2X, Cop2Y, KnobCount };
+
+    struct Range {
+        float low;
+        float high;
+    };
+
+    // Spawns as fractions of the world
+    static constexpr Range ranges[KnobCount] = {
+        {1.5f, 6.0f}, {300.0f, 1500.0f}, {0.0f, 600.0f}, {0.0f, 800.0f}, {0.0f, 1000.0f}, {0.0f, 1000.0f},
+        {0.05f, 0.95f}, {0.05f, 0.95f}, {0.05f, 0.95f}, {0.05f, 0.95f},
+    };
+
+    Tuning base;
+    uint64_t seed;
+    float target;
+    int levels;
+    int dimensions;
+    float worldWidth;
+    float worldHeight;
+    std::vector<Game*> games;
+
+    // Play level `number` from its start until a capture, the level ends or gameTicks run out
+    static bool play(Game& game, const Tuning& tuning, int number, uint64_t runSeed) {
+        game.tuning = tuning;
+        game.startAt(number, runSeed, false); // Games end with the level, so building the next would be wasted
+        for (int t = 0; t < gameTicks && !game.gameOver && !game.robberEscaped && game.level == number; t++) game.step();
+        return game.gameOver && game.level == number;
+    }
+
+    float cost(const float* levelRates) const {
+        float sum = 0.0f;
+        for (int l = 0; l < levels; l++) sum += (levelRates[l] - target) * (levelRates[l] - target);
+        return sum;
+    }
+
+    void describe(const float* levelRates, char* out, size_t size) const {
+        int written = snprintf(out, size, "rates");
+        for (int l = 0; l < levels && written >= 0 && static_cast<size_t>(written) < size; l++) {
+            written += snprintf(out + written, size - written, " %.2f", levelRates[l]);
+        }
+    }
+
+    static float gaussian(Random& rng) {
+        float u = 1.0f - rng.uniform();
+        return sqrtf(-2.0f * logf(u)) * cosf(2.0f * PI * rng.uniform());
+    }
+
+    float scaled(float value, int knob) const {
+        return (value - ranges[knob].low) / (ranges[knob].high - ranges[knob].low);
+    }
+
+    float unscaled(const std::vector<float>& x, int knob) const {
+        return ranges[knob].low + (ranges[knob].high - ranges[knob].low) * std::min(std::max(x[knob], 0.0f), 1.0f);
+    }
+
+    std::vector<float> encode(const Tuning& tuning) const {
+        std::vector<float> x(dimensions);
+        float values[KnobCount] = {tuning.copSpeed, tuning.chaseValue, tuning.supportValue, tuning.escapeValue, tuning.doorValue, tuning.guardValue};
+        if (dimensions > FirstSpawn) {
+            Vector2 cop = tuning.spawn(tuning.copSpawn, static_cast<int>(worldWidth), static_cast<int>(worldHeight));
+            Vector2 cop2 = tuning.spawn(tuning.cop2Spawn, static_cast<int>(worldWidth), static_cast<int>(worldHeight));
+            values[CopX] = cop.x / worldWidth;
+            values[CopY] = cop.y / worldHeight;
+            values[Cop2X] = cop2.x / worldWidth;
+            values[Cop2Y] = cop2.y / worldHeight;
+        }
+        for (int k = 0; k < dimensions; k++) x[k] = std::min(std::max(scaled(values[k], k), 0.0f), 1.0f);
+        return x;
+    }
+
+    // Knobs outside [0, 1] are clamped, so CMA-ES still sees the step it took
+    Tuning decode(const std::vector<float>& x) const {
+        Tuning tuning = base;
+        tuning.copSpeed = unscaled(x, CopSpeed);
+        tuning.chaseValue = unscaled(x, ChaseValue);
+        tuning.supportValue = unscaled(x, SupportValue);
+        tuning.escapeValue = unscaled(x, EscapeValue);
+        tuning.doorValue = unscaled(x, DoorValue);
+        tuning.guardValue = unscaled(x, GuardValue);
+        if (dimensions > FirstSpawn) {
+            tuning.copSpawn = clearOfRobber({unscaled(x, CopX) * worldWidth, unscaled(x, CopY) * worldHeight});
+            tuning.cop2Spawn = clearOfRobber({unscaled(x, Cop2X) * worldWidth, unscaled(x, Cop2Y) * worldHeight});
+        }
+        return tuning;
+    }
+
+    // Classic levels start the robber in the middle; a cop spawned on top of it is no balance
+    Vector2 clearOfRobber(Vector2 spawn) const {
+        Vector2 center = {worldWidth / 2.0f, worldHeight / 2.0f};
+        Vector2 away = VectorUtils::Subtract(spawn, center);
+        float distance = VectorUtils::Length(away);
+        if (distance >= spawnClearance) return spawn;
+        if (distance < 1e-3f) away = {-1.0f, -1.0f};
+        return VectorUtils::Add(center, VectorUtils::Scale(VectorUtils::Normalize(away), spawnClearance));
+    }
+};
+
+constexpr BalanceTuner::Range BalanceTuner::ranges[BalanceTuner::KnobCount];
+
+// Benchmark class for the headless timing runs (--bench)
+class Benchmark {
+public:
+    static void run() {
+        printf("%-34s %10s %10s\n", "case", "walls", "ms");
+        generator(LevelGenerator::RecursiveDivision, 820, 820);
+        generator(LevelGenerator::RoomsAndCorridors, 1400, 1400);
+        generator(LevelGenerator::CellularCaves, 1600, 1600);
+        chunks(820, 820);
+        chokepoints(1000, 1000);
+        levelFile(820, 820);
+        gameState();
+        history();
+        ticks(4000, 4000);
+        pursuit(4000, 4000);
+        registry();
+        broadphase(5000);
+        avoidance(5000);
+        coordinator(200);
+        planner();
+        gridSearch();
+        copTable(20000000);
+        balance();
+        robberBot();
+        policy(5000);
+        influence(200, 200, 8);
+        influence(1024, 1024, 8);
+    }
+
+private:
+    static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Full procedural pipeline on a cols x rows cell map: carve, nav grid, placement, merge
+    static void generator(LevelGenerator::Style style, int cols, int rows) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        LevelGenerator generator(static_cast<float>(cols), static_cast<float>(rows), 1.0f, 1, 1234);
+        generator.generate(style);
+        NavGrid nav;
+        nav.buildFromCells(generator.solid, generator.cols, generator.rows, 1.0f);
+        generator.place(nav.clearance, 1, 5, 2);
+        size_t walls = generator.mergeWalls().size();
+        printf("%-34s %10zu %10.1f\n", TextFormat("generate %s %dx%d", LevelGenerator::styleName(style), cols, rows), walls, millisecondsSince(start));
+    }
+
+    // Chunk index over a 100k-wall division map at game scale, then per-character wall queries
+    static void chunks(int cols, int rows) {
+        const float cell = 20.0f;
+        LevelGenerator generator(cols * cell, rows * cell, cell, 1, 1234);
+        generator.generate(LevelGenerator::RecursiveDivision);
+        std::vector<Wall> walls;
+        for (const Rectangle& rect : generator.mergeWalls()) walls.push_back(Wall(rect));
+        std::vector<Coin> coins;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ChunkGrid grid;
+        grid.build(walls, coins, generator.cols * cell, generator.rows * cell, 512.0f);
+        printf("%-34s %10zu %10.1f\n", "chunk index build", walls.size(), millisecondsSince(start));
+
+        const int queries = 100000;
+        Random rng(99);
+        std::vector<int> ids;
+        std::vector<const Wall*> nearby;
+        size_t found = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++) {
+            Vector2 p = {rng.uniform() * generator.cols * cell, rng.uniform() * generator.rows * cell};
+            grid.chunksUnder({p.x - 25.0f, p.y - 25.0f, 50.0f, 50.0f}, ids);
+            grid.gatherWalls(ids, walls, nearby);
+            found += nearby.size();
+        }
+        printf("%-34s %10zu %10.1f\n", TextFormat("chunk wall query (ms per %dk)", queries / 1000), found / queries, millisecondsSince(start));
+
+        // What Game::draw() submits for an 800x600 view: chunk lookup plus the per-wall rect test
+        const int views = 10000;
+        size_t drawn = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < views; i++) {
+            Rectangle view = {rng.uniform() * (generator.cols * cell - 800.0f), rng.uniform() * (generator.rows * cell - 600.0f), 800.0f, 600.0f};
+            grid.chunksUnder(view, ids);
+            grid.gatherWalls(ids, walls, nearby);
+            for (const Wall* wall : nearby) {
+                if (CheckCollisionRecs(wall->rect, view)) drawn++;
+            }
+        }
+        printf("%-34s %10zu %10.1f\n", TextFormat("view cull (ms per %dk views)", views / 1000), drawn / views, millisecondsSince(start));
+    }
+
+    // Min-cut chokepoints on a 1M-cell division maze, as the level worker runs them
+    static void chokepoints(int cols, int rows) {
+        LevelGenerator generator(static_cast<float>(cols), static_cast<float>(rows), 1.0f, 1, 1234);
+        generator.generate(LevelGenerator::RecursiveDivision);
+        NavGrid nav;
+        nav.buildFromCells(generator.solid, generator.cols, generator.rows, 1.0f);
+        generator.place(nav.clearance, 1, 5, 2);
+        std::vector<Vector2> goals(generator.coinSpawns);
+        goals.push_back(generator.doorCenter);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t found = ChokepointFinder().find(nav, generator.robberSpawn, goals).size();
+        printf("%-34s %10zu %10.1f\n", TextFormat("chokepoints %dx%d (found)", cols, rows), found, millisecondsSince(start));
+    }
+
+    // Save a 100k-wall level, then time mapping it back (header checks, walls materialized, nav and
+    // chunk data borrowed in place)
+    static void levelFile(int cols, int rows) {
+        const float cell = 20.0f;
+        LevelGenerator generator(cols * cell, rows * cell, cell, 1, 1234);
+        generator.generate(LevelGenerator::RecursiveDivision);
+        Level level;
+        level.worldWidth = static_cast<int>(generator.cols * cell);
+        level.worldHeight = static_cast<int>(generator.rows * cell);
+        level.nav.buildFromCells(generator.solid, generator.cols, generator.rows, cell);
+        generator.place(level.nav.clearance, 1, 5, 2);
+        for (const Rectangle& rect : generator.mergeWalls()) level.walls.push_back(Wall(rect));
+        for (const Vector2& coin : generator.coinSpawns) level.coins.push_back(Coin(coin));
+        level.copSpawn = generator.copSpawns[0];
+        level.robberSpawn = generator.robberSpawn;
+        level.chunks.build(level.walls, level.coins, static_cast<float>(level.worldWidth), static_cast<float>(level.worldHeight), 512.0f);
+
+        const char* path = "bench_level.crl";
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (!LevelFile::save(level, path)) return;
+        printf("%-34s %10zu %10.1f\n", "level file save", level.walls.size(), millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        Level loaded;
+        bool ok = LevelFile::load(path, loaded, Tuning());
+        double loadMs = millisecondsSince(start);
+        printf("%-34s %10zu %10.3f\n", ok ? "level file load (mmap)" : "level file load FAILED", loaded.walls.size(), loadMs);
+        remove(path);
+    }
+
+    // Save and restore the live state of a headless game, as a per-tick rollback would
+    static void gameState() {
+        GameOptions options;
+        options.headless = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+        GameState state;
+
+        const int rounds = 100000;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            game.saveState(state);
+            game.loadState(state);
+        }
+        printf("%-34s %10zu %10.1f\n", TextFormat("state save+load (ms per %dk, bytes)", rounds / 1000), state.size(), millisecondsSince(start));
+    }
+
+    // Whole simulation ticks on a large division maze, the robber bot playing against the cops
+    // (captures are ignored so it keeps going)
+    static void ticks(int worldWidth, int worldHeight) {
+        GameOptions options;
+        options.headless = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.style = LevelGenerator::RecursiveDivision;
+        options.worldWidth = worldWidth;
+        options.worldHeight = worldHeight;
+        options.bot = true;
+        options.configPath.clear();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Game game(options);
+        printf("%-34s %10zu %10.1f\n", TextFormat("game start %dx%d", worldWidth, worldHeight), game.walls.size(), millisecondsSince(start));
+
+        const int count = 10000;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            game.step();
+            game.gameOver = false;
+        }
+        printf("%-34s %10zu %10.1f\n", TextFormat("game tick (ms per %dk)", count / 1000), game.walls.size(), millisecondsSince(start));
+    }
+
+    // Pursuit for 8 cops closing in on a robber that wanders a worldWidth x worldHeight map,
+    // open and caves, so the field is rebuilt about as often as in play
+    static void pursuit(int worldWidth, int worldHeight) {
+        const float cell = 20.0f;
+        const LevelGenerator::Style styles[2] = {LevelGenerator::Classic, LevelGenerator::CellularCaves};
+        for (LevelGenerator::Style style : styles) {
+            LevelGenerator generator(static_cast<float>(worldWidth), static_cast<float>(worldHeight), cell, 5, 1234);
+            generator.generate(style);
+            NavGrid nav;
+            nav.buildFromCells(generator.solid, generator.cols, generator.rows, cell);
+            generator.place(nav.clearance, 3, 0, 8);
+            Pursuit pursuit;
+            pursuit.resize(generator.copSpawns.size());
+            for (size_t i = 0; i < generator.copSpawns.size(); i++) {
+                pursuit.x[i] = generator.copSpawns[i].x;
+                pursuit.y[i] = generator.copSpawns[i].y;
+                pursuit.speed[i] = 3.0f;
+            }
+
+            Random rng(7);
+            Vector2 robber = generator.robberSpawn;
+            Vector2 heading = {4.5f, 0.0f};
+            const int count = 10000;
+            double aimMs = 0.0;
+            for (int t = 0; t < count; t++) {
+                Vector2 next = VectorUtils::Add(robber, heading);
+                if (next.x < 0.0f || next.y < 0.0f || next.x >= nav.width * cell || next.y >= nav.height * cell || nav.isBlocked(next)) {
+                    float angle = rng.uniform() * 2.0f * PI;
+                    heading = {4.5f * cosf(angle), 4.5f * sinf(angle)};
+                } else {
+                    robber = next;
+                }
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                pursuit.observe(robber);
+                pursuit.aim(nav, 3);
+                aimMs += millisecondsSince(start);
+                // Cops walk straight at their aim and stop at walls; the field is what keeps them moving
+                for (size_t i = 0; i < pursuit.x.size(); i++) {
+                    Vector2 cop = {pursuit.x[i], pursuit.y[i]};
+                    Vector2 moved = VectorUtils::Add(cop, VectorUtils::Scale(VectorUtils::Normalize(VectorUtils::Subtract(pursuit.aimOf(i), cop)), 3.0f));
+                    if (nav.isBlocked(moved)) continue;
+                    pursuit.x[i] = moved.x;
+                    pursuit.y[i] = moved.y;
+                }
+            }
+            printf("%-34s %10zu %10.3f\n", TextFormat("pursuit %s %dx%d (us/tick)", LevelGenerator::styleName(style), worldWidth, worldHeight),
+                   generator.copSpawns.size(), aimMs * 1000.0 / count);
+
+            // What the cops' own steering toward those aims costs, chunk wall queries included
+            std::vector<Wall> walls;
+            for (const Rectangle& rect : generator.mergeWalls()) walls.push_back(Wall(rect));
+            ChunkGrid chunks;
+            chunks.build(walls, std::vector<Coin>(), generator.cols * cell, generator.rows * cell, 512.0f);
+            std::vector<Cop> cops;
+            for (size_t i = 0; i < pursuit.x.size(); i++) cops.push_back(Cop({pursuit.x[i], pursuit.y[i]}, 20, RED, 3.0f));
+            std::vector<int> ids;
+            std::vector<const Wall*> nearby;
+            Vector2 worldSize = {generator.cols * cell, generator.rows * cell};
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int t = 0; t < count; t++) {
+                for (size_t i = 0; i < cops.size(); i++) {
+                    Cop& cop = cops[i];
+                    chunks.chunksUnder({cop.position.x - 40.0f, cop.position.y - 40.0f, 80.0f, 80.0f}, ids);
+                    chunks.gatherWalls(ids, walls, nearby);
+                    cop.steer(pursuit.aimOf(i), nearby, worldSize);
+                }
+            }
+            printf("%-34s %10zu %10.3f\n", TextFormat("steer %s %dx%d (us/tick)", LevelGenerator::styleName(style), worldWidth, worldHeight),
+                   cops.size(), millisecondsSince(start) * 1000.0 / count);
+        }
+    }
+
+    // Cop churn: despawn a random cop and spawn a replacement, with a population of 5k
+    static void registry() {
+        const int population = 5000;
+        const int rounds = 1000000;
+        Registry<Cop> cops;
+        std::vector<EntityHandle> handles;
+        for (int i = 0; i < population; i++) handles.push_back(cops.spawn(Cop({0.0f, 0.0f}, 20, RED, 3.0f)));
+
+        Random rng(7);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            int victim = rng.range(population);
+            cops.despawn(handles[victim]);
+            handles[victim] = cops.spawn(Cop({static_cast<float>(i), 0.0f}, 20, RED, 3.0f));
+        }
+        printf("%-34s %10zu %10.1f\n", TextFormat("registry respawn (ms per %dk)", rounds / 1000), cops.size(), millisecondsSince(start));
+    }
+
+    // 5k cops jittering around a 4000x4000 world: tick-to-tick sort fix-up plus the pair sweep
+    static void broadphase(int copCount) {
+        const int ticks = 600;
+        Random rng(11);
+        std::vector<Vector2> positions(copCount);
+        for (Vector2& p : positions) p = {rng.uniform() * 4000.0f, rng.uniform() * 4000.0f};
+
+        SweepAndPrune sweep;
+        size_t pairs = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            sweep.beginTick();
+            for (int i = 0; i < copCount; i++) {
+                positions[i].x += (rng.uniform() - 0.5f) * 6.0f;
+                positions[i].y += (rng.uniform() - 0.5f) * 6.0f;
+                sweep.update(SweepAndPrune::CopProxy, static_cast<uint32_t>(i), positions[i], 20.0f);
+            }
+            sweep.sweep();
+            pairs += sweep.pairs.size();
+        }
+        printf("%-34s %10zu %10.3f\n", TextFormat("sweep and prune %d cops (ms/tick)", copCount), pairs / ticks, millisecondsSince(start) / ticks);
+    }
+
+    // 5k cops converging on the middle of a 4000x4000 world, so neighbourhoods fill up as it runs
+    static void avoidance(int copCount) {
+        const int ticks = 300;
+        Random rng(13);
+        OrcaAvoidance orca;
+        orca.resize(copCount);
+        for (int i = 0; i < copCount; i++) {
+            orca.positions[i] = {rng.uniform() * 4000.0f, rng.uniform() * 4000.0f};
+            orca.velocities[i] = {0.0f, 0.0f};
+            orca.radii[i] = 20.0f;
+            orca.maxSpeeds[i] = 3.0f;
+        }
+
+        double worst = 0.0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < copCount; i++) {
+                Vector2 toCenter = VectorUtils::Subtract({2000.0f, 2000.0f}, orca.positions[i]);
+                float distance = VectorUtils::Length(toCenter);
+                orca.preferred[i] = distance > 3.0f ? VectorUtils::Scale(toCenter, 3.0f / distance) : toCenter;
+            }
+            orca.solve();
+            for (int i = 0; i < copCount; i++) {
+                orca.velocities[i] = orca.out[i];
+                orca.positions[i] = VectorUtils::Add(orca.positions[i], orca.out[i]);
+            }
+            worst = std::max(worst, millisecondsSince(tickStart));
+        }
+        printf("%-34s %10d %10.3f\n", TextFormat("orca %d cops (ms/tick)", copCount), copCount, millisecondsSince(start) / ticks);
+        printf("%-34s %10d %10.3f\n", "orca worst tick (ms)", copCount, worst);
+    }
+
+    // 200 cops closing in on a robber circling an open 4000x4000 map: the cold first assignment,
+    // then the warm-started per-tick cost
+    static void coordinator(int copCount) {
+        const int ticks = 600;
+        NavGrid nav;
+        nav.build(std::vector<Wall>(), 4000.0f, 4000.0f, 20.0f);
+        Random rng(17);
+        Pursuit pursuit;
+        pursuit.resize(copCount);
+        for (int i = 0; i < copCount; i++) {
+            pursuit.x[i] = rng.uniform() * 4000.0f;
+            pursuit.y[i] = rng.uniform() * 4000.0f;
+            pursuit.speed[i] = 3.0f;
+        }
+
+        Coordinator coordinator;
+        coordinator.available[Coordinator::DoorSlot] = true;
+        coordinator.points[Coordinator::DoorSlot] = {3900.0f, 3900.0f};
+        double cold = 0.0, total = 0.0;
+        for (int t = 0; t < ticks; t++) {
+            float angle = t * 0.01f;
+            Vector2 robber = {2000.0f + 600.0f * cosf(angle), 2000.0f + 600.0f * sinf(angle)};
+            pursuit.observe(robber);
+            pursuit.aim(nav, 2);
+            for (int d = 0; d < Pursuit::escapeDirections; d++) {
+                coordinator.available[Coordinator::FirstEscape + d] = pursuit.escapeFound[d];
+                coordinator.points[Coordinator::FirstEscape + d] = pursuit.escapePoints[d];
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            coordinator.assign(pursuit, robber, pursuit.velocity());
+            double elapsed = millisecondsSince(start);
+            if (t == 0) cold = elapsed;
+            else total += elapsed;
+            for (int i = 0; i < copCount; i++) {
+                Vector2 step = VectorUtils::Scale(VectorUtils::Normalize(VectorUtils::Subtract(pursuit.aimOf(i), {pursuit.x[i], pursuit.y[i]})), 3.0f);
+                pursuit.x[i] += step.x;
+                pursuit.y[i] += step.y;
+            }
+        }
+        printf("%-34s %10d %10.3f\n", TextFormat("assign %d cops, cold (us)", copCount), copCount, cold * 1000.0);
+        printf("%-34s %10d %10.3f\n", TextFormat("assign %d cops, warm (us/tick)", copCount), copCount, total * 1000.0 / (ticks - 1));
+    }
+
+    // Hard mode against the robber bot: the whole tick against the 2 ms
+    // search budget, and how many rollouts the cores fit into it
+    static void planner() {
+        const int ticks = 300;
+        GameOptions options;
+        options.headless = true;
+        options.hard = true;
+        options.bot = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ticks; i++) {
+            game.step();
+            game.gameOver = false;
+        }
+        int searchers = game.planner->workerCount + 1;
+        printf("%-34s %10d %10.3f\n", "mcts tick, searchers (ms/tick)", searchers, millisecondsSince(start) / ticks);
+        printf("%-34s %10d %10s\n", "mcts rollouts per tick", static_cast<int>(game.planner->rollouts() / ticks), "");
+    }
+
+    // The exported-level analysis on the first level of a division maze: how deep the cores get
+    // in 200 ms and how fast they go
+    static void gridSearch() {
+        GameOptions options;
+        options.headless = true;
+        options.style = LevelGenerator::RecursiveDivision;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+        Level first = LevelBuilder(game.worldWidth, game.worldHeight, game.wallThickness, game.tuning, options.seed, options.style).build(1);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        GridSearch::Result result = {0, -1, 0, 0};
+        if (!game.analyze(first, 200.0, result)) return;
+        double elapsed = millisecondsSince(start);
+        printf("%-34s %10d %10.1f\n", "grid search depth in 200 ms", result.depth, elapsed);
+        printf("%-34s %10d %10s\n", "grid search knodes/s", static_cast<int>(result.nodes / elapsed), "");
+    }
+
+    // A 16-32-32-2 policy with int8 hidden layers over 5k cops on an open map: the batch with
+    // each kernel set, and how far the scalar headings drift from the AVX2 ones
+    static void policy(int copCount) {
+        const int rounds = 20;
+        NavGrid nav;
+        nav.build(std::vector<Wall>(), 4000.0f, 4000.0f, 20.0f);
+        Random rng(19);
+        Pursuit pursuit;
+        pursuit.resize(copCount);
+        for (int i = 0; i < copCount; i++) {
+            pursuit.x[i] = rng.uniform() * 4000.0f;
+            pursuit.y[i] = rng.uniform() * 4000.0f;
+            pursuit.speed[i] = 3.0f;
+        }
+        pursuit.observe({2000.0f, 2000.0f});
+
+        CopNet net;
+        net.randomize({CopNet::featureCount, 32, 32, CopNet::outputCount}, true, 23);
+        const char* path = "bench_policy.crn";
+        CopNet loaded;
+        bool ok = net.save(path) && loaded.load(path);
+        remove(path);
+        if (!ok) {
+            printf("%-34s %10s %10s\n", "policy save+load FAILED", "", "");
+            return;
+        }
+
+        std::vector<Vector2> fast, plain;
+        bool simd = loaded.simd;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            loaded.gather(nav, pursuit, {2000.0f, 2000.0f});
+            loaded.run(fast);
+        }
+        double fastMs = millisecondsSince(start) / rounds;
+        loaded.simd = false;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            loaded.gather(nav, pursuit, {2000.0f, 2000.0f});
+            loaded.run(plain);
+        }
+        double plainMs = millisecondsSince(start) / rounds;
+        float drift = 0.0f;
+        for (int i = 0; i < copCount; i++) drift = std::max(drift, VectorUtils::Length(VectorUtils::Subtract(fast[i], plain[i])));
+
+        printf("%-34s %10d %10.3f\n", simd ? "policy AVX2 (us/cop)" : "policy, no AVX2 (us/cop)", copCount, fastMs * 1000.0 / copCount);
+        printf("%-34s %10d %10.3f\n", "policy scalar (us/cop)", copCount, plainMs * 1000.0 / copCount);
+        printf("%-34s %10d %10.6f\n", "policy AVX2 vs scalar drift", copCount, drift);
+    }
+
+    // One tick's update of all three layers on a cols x rows grid in 512 px chunks, with the robber
+    // and `copCount` cops activating the chunks around them as in play, for each kernel (the two
+    // must agree to the bit); then the same with every chunk active, and the coin layer's settle
+    static void influence(int cols, int rows, int copCount) {
+        const int rounds = 50;
+        float worldWidth = cols * 20.0f;
+        float worldHeight = rows * 20.0f;
+        NavGrid nav;
+        nav.build(std::vector<Wall>(), worldWidth, worldHeight, 20.0f);
+        ChunkGrid chunks;
+        chunks.build(std::vector<Wall>(), std::vector<Coin>(), worldWidth, worldHeight, 512.0f);
+        Random rng(29);
+        Registry<Cop> cops;
+        Registry<Coin> coins;
+        for (int i = 0; i < copCount; i++) cops.spawn(Cop({rng.uniform() * worldWidth, rng.uniform() * worldHeight}, 20, RED, 3.0f));
+        for (int i = 0; i < 50; i++) coins.spawn(Coin({rng.uniform() * worldWidth, rng.uniform() * worldHeight}));
+
+        InfluenceMap fast, plain;
+        bool simd = fast.simd;
+        plain.simd = false;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        fast.build(nav, coins);
+        double buildMs = millisecondsSince(start);
+        plain.build(nav, coins);
+        double fastMs = 0.0, plainMs = 0.0;
+        for (int r = 0; r < rounds; r++) {
+            Vector2 robber = {worldWidth / 2 + r * 20.0f, worldHeight / 2};
+            chunks.beginTick();
+            chunks.activate(robber, 1);
+            for (const Cop& cop : cops) chunks.activate(cop.position, 1);
+            start = std::chrono::steady_clock::now();
+            fast.update(chunks, robber, cops, coins);
+            fastMs += millisecondsSince(start);
+            start = std::chrono::steady_clock::now();
+            plain.update(chunks, robber, cops, coins);
+            plainMs += millisecondsSince(start);
+        }
+        size_t activeCells = fast.activeCells();
+        int mismatches = 0;
+        for (int layer = 0; layer < InfluenceMap::LayerCount; layer++) {
+            for (int cell = 0; cell < cols * rows; cell++) {
+                InfluenceMap::Layer l = static_cast<InfluenceMap::Layer>(layer);
+                if (fast.at(l, cell) != plain.at(l, cell)) mismatches++;
+            }
+        }
+
+        double fullMs = 0.0;
+        for (int r = 0; r < rounds; r++) {
+            chunks.beginTick();
+            chunks.activate({worldWidth / 2, worldHeight / 2}, std::max(chunks.cols, chunks.rows));
+            start = std::chrono::steady_clock::now();
+            fast.update(chunks, {worldWidth / 2, worldHeight / 2}, cops, coins);
+            fullMs += millisecondsSince(start);
+        }
+
+        printf("%-34s %10zu %10.3f\n", simd ? "influence update AVX2" : "influence update, no AVX2", activeCells, fastMs / rounds);
+        printf("%-34s %10zu %10.3f\n", "influence update scalar", activeCells, plainMs / rounds);
+        printf("%-34s %10d %10d\n", "influence AVX2 vs scalar mismatches", cols * rows, mismatches);
+        printf("%-34s %10d %10.3f\n", "influence update, all chunks", cols * rows, fullMs / rounds);
+        printf("%-34s %10d %10.3f\n", "influence build (coins settled)", cols * rows, buildMs);
+    }
+
+    // Self-play on the first recursive-division level's coarse grid over every core: how fast
+    // a CopTable trains
+    static void copTable(uint64_t steps) {
+        GameOptions options;
+        options.headless = true;
+        options.style = LevelGenerator::RecursiveDivision;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+        Level first = LevelBuilder(game.worldWidth, game.worldHeight, game.wallThickness, game.tuning, options.seed, options.style).build(1);
+        GridChase grid;
+        grid.build(first.nav, static_cast<float>(game.tuning.copRadius), CopTable::maxCells);
+        CopTable::Table table = CopTable::blank(1, grid);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        QTrainer trainer;
+        QTrainer::Report report = trainer.train(grid, 1 + static_cast<int>(first.cops.size()), steps, std::max(1, static_cast<int>(std::thread::hardware_concurrency())), 1234, table);
+        double elapsed = millisecondsSince(start);
+        printf("%-34s %10d %10.1f\n", "cop table self-play (cells)", grid.width * grid.height, elapsed);
+        printf("%-34s %10.1f %10s\n", "cop table Msteps/s", report.steps / elapsed / 1000.0, "");
+        printf("%-34s %10.3f %10s\n", "cop table capture rate", static_cast<double>(report.captures) / std::max<uint64_t>(1, report.episodes), "");
+    }
+
+    // One candidate's games on every stock level over every core; a tuning generation plays
+    // this many for each member of its population
+    static void balance() {
+        GameOptions options;
+        options.headless = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+        BalanceTuner tuner(options, game.tuning, options.seed, 0.5f);
+        std::vector<Tuning> candidate(1, game.tuning);
+        std::vector<float> rates;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        tuner.evaluate(candidate, options.seed, rates);
+        printf("%-34s %10d %10.1f\n", "balance candidate (games)", game.lastLevel * BalanceTuner::gamesPerLevel, millisecondsSince(start));
+    }
+
+    // The bot playing the stock levels: its decisions timed on their own, field rebuilds included
+    static void robberBot() {
+        const int ticks = 20000;
+        GameOptions options;
+        options.headless = true;
+        options.bot = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+
+        double total = 0.0;
+        int played = 0;
+        for (; played < ticks && game.level <= game.lastLevel && !game.robberEscaped; played++) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            game.robberBot.steer(game.nav, game.robber.position, static_cast<float>(game.robber.radius), game.coins, game.influence);
+            total += millisecondsSince(start);
+            game.step();
+            game.gameOver = false; // Play on through captures
+        }
+        printf("%-34s %10d %10.3f\n", "robber bot decision (us)", played, total * 1000.0 / played);
+    }
+
+    // A full rewind window of play (the robber bot against the cops), then the memory it
+    // took and the slowest restore: the last frame before a keyframe
+    static void history() {
+        GameOptions options;
+        options.headless = true;
+        options.bot = true;
+        options.fixedSeed = true;
+        options.seed = 1234;
+        options.configPath.clear();
+        Game game(options);
+
+        int ticks = game.historySeconds * game.targetFPS;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ticks; i++) {
+            game.step();
+            game.gameOver = false; // Keep the chase going past captures so every tick changes
+        }
+        printf("%-34s %10d %10.1f\n", TextFormat("history record (ms per %ds)", game.historySeconds), ticks, millisecondsSince(start));
+        printf("%-34s %10zu %10s\n", "history size (KB)", game.history.bytes() / 1024, "");
+
+        GameState state;
+        start = std::chrono::steady_clock::now();
+        game.history.restore(StateHistory::keyInterval - 1, state);
+        printf("%-34s %10zu %10.3f\n", "history restore, worst case", state.size(), millisecondsSince(start));
+    }
+};
+
+int main(int argc, char** argv) {
+    GameOptions options;
+    if (!options.parse(argc, argv)) return 1;
+    if (options.bench) {
+        Benchmark::run();
+        return 0;
+    }
+
+    Game game(options);
+    if (!options.exportDir.empty()) {
+        return game.exportLevels(options.exportDir.c_str()) ? 0 : 1;
+    }
+    if (!options.trainPath.empty()) {
+        return game.trainTables(options.trainPath.c_str()) ? 0 : 1;
+    }
+    if (!options.tunePath.empty()) {
+        BalanceTuner tuner(options, game.tuning, game.seed, options.captureRate);
+        return tuner.run(options.tunePath.c_str()) ? 0 : 1;
+    }
+    if (options.soakTicks > 0) {
+        game.soak(options.soakTicks);
+        return 0;
+    }
     game.run();
     return 0;
 }